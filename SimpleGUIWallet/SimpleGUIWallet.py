@@ -9,6 +9,8 @@
 #     --sender=<name>      (Default: None)
 #     --node=<api_node>    (Default: "wss://bitshares.openledger.info/ws")
 #     --path=<bip32_path>  (Default: "48'/1'/1'/0'/0'")
+#     --cache=<file>       (Default: ~/.SimpleGUIWallet/metadata.sqlite)
+#     --no-cache           Don't cache account/asset metadata on disk
 #
 # Dependencies:
 #
@@ -38,6 +40,8 @@ from bitshares.account import Account
 from graphenecommon.exceptions import AccountDoesNotExistsException
 from wallet_forms import *
 from wallet_actions import *
+from nano_session import closeNanoSession
+from rpc_worker import RpcWorker
 from logger import Logger
 
 ##
@@ -47,6 +51,8 @@ parser = argparse.ArgumentParser()
 parser.add_argument('--node', help="specify a BitShares API node to use")
 parser.add_argument('--user', help="set BitShares user account name")
 parser.add_argument('--path', help="SLIP-0048 path to use for signing")
+parser.add_argument('--cache', help="file for caching account and asset metadata")
+parser.add_argument('--no-cache', help="don't cache account and asset metadata", action='store_true')
 args = parser.parse_args()
 
 if args.node is None:
@@ -58,6 +64,11 @@ if args.path is None:
 if args.user is None:
     args.user = ""
 
+if args.cache is None:
+    args.cache = METADATA_CACHE_PATH
+if args.no_cache:
+    args.cache = None
+
 bip32_path = args.path
 default_sender = args.user
 
@@ -83,6 +94,7 @@ if __name__ == "__main__":
     gui.title("Super-Simple BitShares Wallet for Ledger Nano")
     gui.geometry("800x600")
     gui.minsize(640,480)
+    rpc = RpcWorker(gui)    # Runs blockchain queries off the Tk thread
     gui_style = ttk.Style()
     gui_style.theme_use('clam')
     gui_style.map("TEntry",fieldbackground=[("readonly", gui_style.lookup("TFrame", "background")), ("disabled", gui_style.lookup("TFrame", "background"))])
@@ -150,16 +162,25 @@ if __name__ == "__main__":
     def broadcastSignedTx():  # Combine var_tx_json & var_tx_signature, broadcast
         sigHex = var_tx_signature.get().strip()
         sig_bytes = binascii.unhexlify(sigHex)
-        broadcastTxWithProvidedSignature(var_tx_json.get(), sig_bytes)
-        gui.after(3200, account_info_refresh) # Wait-a-block, then refresh
+        rpc.submit(None, broadcastTxWithProvidedSignature, var_tx_json.get(), sig_bytes,
+                   on_done=lambda result: gui.after(3200, account_info_refresh), # Wait-a-block, then refresh
+                   on_error=lambda e: None)     # Already logged
 
     def sendTransfer(from_name, to_name, amount, symbol):
+        # Building the tx takes several lookups, so is done on the RPC worker;
+        # a repeat click while that is in flight is merged into it.  Signing
+        # then proceeds on the main thread, as it involves the user.
+        var_tx_json.set("")
+        var_tx_serial.set("")
+        var_tx_signature.set("")
+        Logger.Write("Preparing to send %f %s from \"%s\" to \"%s\"..." % (amount, symbol, from_name, to_name))
+        rpc.submit(("transfer", from_name, to_name, amount, symbol),
+                   generateTransferTxJSON, from_name, to_name, amount, symbol,
+                   on_done=signAndBroadcastTransfer,
+                   on_error=lambda e: Logger.Write("Transfer not sent."))
+
+    def signAndBroadcastTransfer(tx_json):
         try:
-            var_tx_json.set("")
-            var_tx_serial.set("")
-            var_tx_signature.set("")
-            Logger.Write("Preparing to send %f %s from \"%s\" to \"%s\"..." % (amount, symbol, from_name, to_name))
-            tx_json = generateTransferTxJSON(from_name, to_name, amount, symbol)
             var_tx_json.set(tx_json)
             serializeTxJSON()
             signTxHexBytes()
@@ -171,18 +192,17 @@ if __name__ == "__main__":
     ## Whoami Frame:
     ##
     def account_info_refresh():
-        try:
-            spending_account = Account(var_from_account_name.get(), blockchain_instance=blockchain)
-            balances = spending_account.balances
-            history = spending_account.history(limit=40)
-            account_id = spending_account.identifier
-        except AccountDoesNotExistsException:
-            Logger.Write("ERROR: Specified account does not exist on BitShares network.")
-            balances = []
-            history = []
-            account_id = ""
-        frameAssets.setBalances(balances)
-        frameHistory.setHistory(history, account_id)
+        account_name = var_from_account_name.get()
+        def show(info):
+            if account_name != var_from_account_name.get():
+                return  # Account changed while we were fetching; a newer refresh follows
+            balances, history, account_id, labels = info
+            frameAssets.setBalances(balances)
+            frameHistory.setHistory(history, account_id, labels)
+        def failed(e):
+            Logger.Write("ERROR: Could not refresh account info: %s" % str(e))
+        rpc.submit(("account_info", account_name), getAccountInfo, account_name,
+                   on_done=show, on_error=failed)
 
     frameWhoAmI = WhoAmIFrame(frame_top, textvariable=var_from_account_name,
                               textvar_bip32_path=var_bip32_path,
@@ -199,7 +219,19 @@ if __name__ == "__main__":
     frameAssets = AssetListFrame(tabbed_AccountInfo, assettextvariable=var_selected_asset)
     frameAssets.pack(side="left", expand=False, fill="y")
 
-    frameHistory = HistoryListFrame(tabbed_AccountInfo, jsonvar=var_tx_json)
+    def history_load_more(account_id, before):  # Called on scroll to bottom of history
+        def fetch():
+            items = getOlderHistory(account_id, before)
+            return items, historyLabels(items, account_id, resolve_times=0)
+        def show(result):
+            frameHistory.appendHistory(result[0], account_id, result[1])
+        def failed(e):
+            frameHistory.loadingMore = False    # Will retry on next scroll
+            Logger.Write("ERROR: Could not load older history: %s" % str(e))
+        rpc.submit(("history_more", account_id, before), fetch, on_done=show, on_error=failed)
+
+    frameHistory = HistoryListFrame(tabbed_AccountInfo, jsonvar=var_tx_json,
+                                    loadmorecommand=history_load_more)
     frameHistory.pack()
 
     tabbed_AccountInfo.add(frameAssets, text = 'Assets')
@@ -225,10 +257,19 @@ if __name__ == "__main__":
     ## Public Keys Tab:
     ##
 
+    def discoverAccounts():
+        def failed(e):
+            Logger.Write("ERROR: Account discovery failed: %s" % str(e))
+            form_pubkeys.setDiscovered(None, {})
+        rpc.submit("discover", discoverAccountKeys,
+                   on_done=lambda result: form_pubkeys.setDiscovered(*result),
+                   on_error=failed)
+
     form_pubkeys = QueryPublicKeysFrame(tabbed_Active,
                                         textvar_bip32_path=var_bip32_path,
                                         textvar_bip32_key=var_bip32_key,
-                                        lookupcommand=getPublicKeyListFromNano)
+                                        lookupcommand=getPublicKeyListFromNano,
+                                        discovercommand=discoverAccounts)
     form_pubkeys.pack(expand=True, fill="both")
 
     ##
@@ -276,7 +317,7 @@ if __name__ == "__main__":
         var_bip32_key.set(tmp_keys[0])
     Logger.Write("Initializing: Looking for BitShares network...")
     global blockchain
-    blockchain = initBlockchainObject(args.node)
+    blockchain = initBlockchainObject(args.node, args.cache)
     var_api_node_url.set(blockchain.rpc.connection.url)
     var_from_account_name.set(default_sender.strip().lower())
     if is_valid_account_name(var_from_account_name.get()):
@@ -285,6 +326,8 @@ if __name__ == "__main__":
     log_print_startup_message()
     # start the GUI
     gui.mainloop()
+    rpc.shutdown()
+    closeNanoSession()
 
 ##
 ## END
@@ -0,0 +1,148 @@
+##
+## Discovers which SLIP-0048 keys on the Nano are in use on chain.
+##
+## Paths follow 48' / network' / role' / account-index' / key-index', with
+## roles owner (0'), active (1') and memo (3').  For each account index, each
+## role's key indices are walked until `gap_limit` consecutive keys are found
+## that no account references.  Account indices are walked until
+## `account_gap_limit` consecutive indices turn up nothing in any role.
+##
+## The device is much slower than the node, so keys are fetched from the device
+## one batch ahead, on their own thread, while the previous batch is looked up
+## on chain with a single get_key_references call.  With a MetadataCache,
+## derived keys are remembered per device (identified by its first owner key)
+## and key references for an hour, so a rescan touches the device once and the
+## node only for expired entries.
+##
+## Used by SimpleGUIWallet and by discoverAccounts.py, so this module does not
+## write to the GUI Logger; pass `progress` to receive status messages.
+##
+
+from collections import namedtuple
+from concurrent.futures import Future, ThreadPoolExecutor
+
+ROLES = (('owner', 0), ('active', 1), ('memo', 3))
+DEFAULT_GAP_LIMIT = 5
+DEFAULT_MAX_ACCOUNTS = 20
+
+DiscoveredKey = namedtuple('DiscoveredKey', ['role', 'accountIndex', 'keyIndex', 'path', 'key', 'accounts'])
+
+
+def slip48Path(role, accountIndex, keyIndex, network=1):
+    return "48'/%d'/%d'/%d'/%d'" % (network, role, accountIndex, keyIndex)
+
+
+class AccountDiscovery:
+
+    def __init__(self, getKeys, getKeyReferences, cache=None, gap_limit=DEFAULT_GAP_LIMIT,
+                 account_gap_limit=1, max_accounts=DEFAULT_MAX_ACCOUNTS, roles=ROLES,
+                 network=1, progress=None):
+        """
+        `getKeys(paths)` returns the device's address string for each path in
+        `paths`, in order.  `getKeyReferences(keys)` returns, for each key, the
+        list of account ids that reference it (as get_key_references does).
+        Both may raise; the exception propagates out of run().
+        """
+        self.getKeys = getKeys
+        self.getKeyReferences = getKeyReferences
+        self.cache = cache
+        self.gap_limit = gap_limit
+        self.account_gap_limit = account_gap_limit
+        self.max_accounts = max_accounts
+        self.roles = roles
+        self.network = network
+        self.progress = progress or (lambda message: None)
+        self.device = None
+        self.stats = {'deviceKeys': 0, 'cachedKeys': 0, 'chainLookups': 0, 'cachedRefs': 0}
+
+    def run(self):
+        """Returns a list of DiscoveredKey for every referenced key found."""
+        with ThreadPoolExecutor(max_workers=1, thread_name_prefix="nano") as deviceThread:
+            self.deviceThread = deviceThread
+            self.device = self._fingerprint()
+            found = []
+            idle = 0
+            for accountIndex in range(self.max_accounts):
+                self.progress("Scanning account index %d'..." % accountIndex)
+                used = []
+                for roleName, role in self.roles:
+                    used.extend(self._scanRole(roleName, role, accountIndex))
+                if used:
+                    found.extend(used)
+                    idle = 0
+                else:
+                    idle += 1
+                    if idle >= self.account_gap_limit:
+                        break
+        return found
+
+    def _fingerprint(self):
+        # Derived keys are cached per seed, so identify the seed by a key the
+        # device is always asked for.  This one query is never cached.
+        path = slip48Path(self.roles[0][1], 0, 0, self.network)
+        key = self.getKeys([path])[0]
+        self.stats['deviceKeys'] += 1
+        if self.cache:
+            self.cache.putDeviceKey(key, path, key)
+        return key
+
+    def _fetchKeys(self, paths):
+        # Returns a Future for the keys at `paths`; resolved immediately if all
+        # are cached, else queued on the device thread.
+        cached = [self.cache.getDeviceKey(self.device, p) for p in paths] if self.cache else [None] * len(paths)
+        if all(k is not None for k in cached):
+            self.stats['cachedKeys'] += len(paths)
+            future = Future()
+            future.set_result(cached)
+            return future
+        def fetch():
+            missing = [p for p, k in zip(paths, cached) if k is None]
+            fetched = dict(zip(missing, self.getKeys(missing)))
+            self.stats['deviceKeys'] += len(missing)
+            self.stats['cachedKeys'] += len(paths) - len(missing)
+            if self.cache:
+                for p, k in fetched.items():
+                    self.cache.putDeviceKey(self.device, p, k)
+            return [k if k is not None else fetched[p] for p, k in zip(paths, cached)]
+        return self.deviceThread.submit(fetch)
+
+    def _lookupReferences(self, keys):
+        refs = [self.cache.getKeyReferences(k) for k in keys] if self.cache else [None] * len(keys)
+        missing = [k for k, r in zip(keys, refs) if r is None]
+        self.stats['cachedRefs'] += len(keys) - len(missing)
+        if missing:
+            self.stats['chainLookups'] += 1
+            fetched = dict(zip(missing, self.getKeyReferences(missing)))
+            if self.cache:
+                for k, r in fetched.items():
+                    self.cache.putKeyReferences(k, r)
+            refs = [r if r is not None else fetched[k] for k, r in zip(keys, refs)]
+        return refs
+
+    def _scanRole(self, roleName, role, accountIndex):
+        def batchPaths(start):
+            return [slip48Path(role, accountIndex, i, self.network)
+                    for i in range(start, start + self.gap_limit)]
+        found = []
+        unused = 0
+        start = 0
+        paths = batchPaths(start)
+        pending = self._fetchKeys(paths)
+        while True:
+            keys = pending.result()
+            # Get the next batch coming off the device while we ask the node
+            # about this one.  At most one batch is fetched needlessly.
+            nextPaths = batchPaths(start + len(paths))
+            pending = self._fetchKeys(nextPaths)
+            for offset, (path, key, accounts) in enumerate(
+                    zip(paths, keys, self._lookupReferences(keys))):
+                if accounts:
+                    found.append(DiscoveredKey(roleName, accountIndex, start + offset, path, key, accounts))
+                    unused = 0
+                else:
+                    unused += 1
+                    if unused >= self.gap_limit:
+                        pending.cancel()
+                        return found
+            start += len(paths)
+            paths = nextPaths
@@ -0,0 +1,144 @@
+##
+## Splits a TLV-encoded transaction into INS_SIGN APDUs.
+##
+## Each APDU carries at most 255 data bytes (Lc is a single byte).  The first
+## APDU also carries the BIP32 path (one count byte plus four bytes per element),
+## so it has less room for transaction data than the rest.  We fill every APDU to
+## capacity, which minimizes round trips to the device.
+##
+## If a memo key path is given, the first APDU carries it too, after the signing
+## path and in the same form, and sets P2 to P2_MEMO_KEY so that the device can
+## decrypt transfer memos for review.
+##
+## Optionally, chunk boundaries can be aligned to TLV field boundaries, so that
+## the device receives each field whole within one APDU where the field fits.
+## This costs at most a few extra APDUs but means the device rarely has to carry
+## a partial field across APDUs.
+##
+## Memos are encrypted on the device with INS_ENCRYPT_MEMO, also over several
+## APDUs: the first carries the memo key path, recipient key, nonce, checksum and
+## text length, and every APDU carries up to MEMO_MAX_CHUNK bytes of text.  Each
+## response is the ciphertext of the blocks completed so far.
+##
+
+from collections import namedtuple
+import hashlib
+import struct
+import time
+
+CLA = 0xB5
+INS_SIGN = 0x04
+INS_ENCRYPT_MEMO = 0x08
+P1_FIRST = 0x00
+P1_MORE = 0x80
+P2_NO_MEMO_KEY = 0x00
+P2_MEMO_KEY = 0x01
+MAX_APDU_DATA = 255
+MEMO_MAX_CHUNK = 224    # Text per INS_ENCRYPT_MEMO APDU; see src/app_memo.h
+
+SignStats = namedtuple('SignStats', ['apduCount', 'dataBytes', 'seconds'])
+
+
+def tlvFieldEnds(tlv):
+    """
+    Returns the offset just past each DER/TLV field in `tlv`.  Raises ValueError
+    if `tlv` is not a flat sequence of well-formed TLV fields.
+    """
+    ends = []
+    pos = 0
+    while pos < len(tlv):
+        if pos + 2 > len(tlv):
+            raise ValueError("Truncated TLV header at offset %d" % pos)
+        length = tlv[pos + 1]
+        pos += 2
+        if length & 0x80:
+            nbytes = length & 0x7f
+            if nbytes == 0 or pos + nbytes > len(tlv):
+                raise ValueError("Bad TLV length at offset %d" % (pos - 1))
+            length = int.from_bytes(tlv[pos:pos + nbytes], 'big')
+            pos += nbytes
+        pos += length
+        if pos > len(tlv):
+            raise ValueError("TLV field overruns buffer")
+        ends.append(pos)
+    return ends
+
+
+def chunkTxForSigning(serial_tx_bytes, donglePath, align_fields=False, max_apdu_data=MAX_APDU_DATA,
+                      memoPath=None):
+    """
+    Returns a list of APDUs (as bytes) that together deliver `serial_tx_bytes` to
+    the device for signing with key at `donglePath` (as from parse_bip32_path).
+    If `memoPath` is given (in the same form), the device decrypts transfer memos
+    with the key at that path for display.
+    """
+    pathPrefix = bytes([len(donglePath) // 4]) + donglePath
+    p2 = P2_NO_MEMO_KEY
+    if memoPath:
+        pathPrefix += bytes([len(memoPath) // 4]) + memoPath
+        p2 = P2_MEMO_KEY
+    if len(pathPrefix) >= max_apdu_data:
+        raise ValueError("BIP32 path too long to fit in APDU")
+    fieldEnds = tlvFieldEnds(serial_tx_bytes) if align_fields else []
+
+    apdus = []
+    offset = 0
+    while offset < len(serial_tx_bytes) or not apdus:
+        first = not apdus
+        capacity = max_apdu_data - (len(pathPrefix) if first else 0)
+        end = min(offset + capacity, len(serial_tx_bytes))
+        if align_fields and end < len(serial_tx_bytes):
+            # Back off to the last field boundary that fits, unless no whole field
+            # fits, in which case the field will have to span APDUs anyway.
+            fitting = [e for e in fieldEnds if offset < e <= end]
+            if fitting:
+                end = fitting[-1]
+        chunk = serial_tx_bytes[offset:end]
+        if first:
+            data = pathPrefix + chunk
+            header = bytes([CLA, INS_SIGN, P1_FIRST, p2, len(data)])
+        else:
+            data = chunk
+            header = bytes([CLA, INS_SIGN, P1_MORE, 0x00, len(data)])
+        apdus.append(header + data)
+        offset = end
+    return apdus
+
+
+def chunkMemoForEncryption(text, memoPath, recipientKey, nonce):
+    """
+    Returns a list of APDUs (as bytes) that have the device encrypt `text` (bytes)
+    from the memo key at `memoPath` (as from parse_bip32_path) to `recipientKey`
+    (33-byte compressed public key) with `nonce`.  The concatenated responses are
+    the memo's message.
+    """
+    if len(recipientKey) != 33:
+        raise ValueError("Recipient key must be 33 bytes, compressed")
+    header = (bytes([len(memoPath) // 4]) + memoPath + recipientKey + struct.pack('>Q', nonce)
+              + hashlib.sha256(text).digest()[:4] + struct.pack('>I', len(text)))
+    apdus = []
+    offset = 0
+    while offset < len(text) or not apdus:
+        first = not apdus
+        capacity = min(MEMO_MAX_CHUNK, MAX_APDU_DATA - (len(header) if first else 0))
+        chunk = text[offset:offset + capacity]
+        data = (header if first else b'') + chunk
+        apdus.append(bytes([CLA, INS_ENCRYPT_MEMO, P1_FIRST if first else P1_MORE, 0x00, len(data)]) + data)
+        offset += len(chunk)
+    return apdus
+
+
+def sendSignApdus(session, apdus):
+    """
+    Sends `apdus` in order over `session` (a NanoSession).  Returns the final
+    response, which is the signature, and a SignStats record.  Exceptions from the
+    session propagate to the caller.
+    """
+    start = time.monotonic()
+    result = None
+    for idx, apdu in enumerate(apdus):
+        result = session.exchange(apdu, reconnect=(idx == 0))
+    stats = SignStats(apduCount=len(apdus),
+                      dataBytes=sum(len(a) - 5 for a in apdus),
+                      seconds=time.monotonic() - start)
+    return result, stats
@@ -0,0 +1,154 @@
+##
+## Preview of what the Nano will display for a transaction, computed on the host
+## by the app's own C parser and printers (host/libbtspreview.so, built with
+## `make -C host`).  Lets the wallet show the exact label/value screens before
+## anything is sent, and reject transactions the device would refuse without a
+## round trip.
+##
+## The library is located via the BTS_PREVIEW_LIB environment variable, or else
+## ../host/libbtspreview.so relative to this file.  If it can't be loaded,
+## isAvailable() returns False and callers should skip the preview.
+##
+
+import ctypes
+import os
+from collections import namedtuple
+
+STREAM_PROCESSING = 0
+STREAM_FINISHED = 1
+STREAM_FAULT = 2
+
+LABEL_SIZE = 48     # BTS_PREVIEW_LABEL_SIZE
+VALUE_SIZE = 128    # BTS_PREVIEW_VALUE_SIZE
+
+Preview = namedtuple('Preview', ['screens', 'txId', 'msgHash', 'unsupportedOps'])
+
+
+class PreviewError(Exception):
+    """The device would reject this transaction."""
+    pass
+
+
+class _Screen(ctypes.Structure):
+    _fields_ = [('label', ctypes.c_char * LABEL_SIZE),
+                ('value', ctypes.c_char * VALUE_SIZE)]
+
+
+_lib = None
+_loadError = None
+
+def _load():
+    global _lib, _loadError
+    if _lib is not None or _loadError is not None:
+        return _lib
+    path = os.environ.get('BTS_PREVIEW_LIB') or os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), '..', 'host', 'libbtspreview.so')
+    try:
+        lib = ctypes.CDLL(path)
+    except OSError as e:
+        _loadError = e
+        return None
+    lib.btsPreviewParse.argtypes = [ctypes.c_char_p, ctypes.c_uint32]
+    lib.btsPreviewParse.restype = ctypes.c_int
+    lib.btsPreviewBegin.argtypes = []
+    lib.btsPreviewBegin.restype = None
+    lib.btsPreviewFeed.argtypes = [ctypes.c_char_p, ctypes.c_uint32]
+    lib.btsPreviewFeed.restype = ctypes.c_int
+    lib.btsPreviewDigests.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+    lib.btsPreviewDigests.restype = None
+    lib.btsPreviewOperationCount.argtypes = []
+    lib.btsPreviewOperationCount.restype = ctypes.c_uint32
+    lib.btsPreviewOperationSupported.argtypes = [ctypes.c_uint32]
+    lib.btsPreviewOperationSupported.restype = ctypes.c_int
+    lib.btsPreviewRender.argtypes = [ctypes.POINTER(_Screen), ctypes.c_uint32]
+    lib.btsPreviewRender.restype = ctypes.c_uint32
+    _lib = lib
+    return _lib
+
+
+def isAvailable():
+    return _load() is not None
+
+
+def library():
+    """The loaded ctypes library; raises RuntimeError if unavailable."""
+    lib = _load()
+    if lib is None:
+        raise RuntimeError("Preview library not available: %s" % _loadError)
+    return lib
+
+
+def begin():
+    """Resets the parser for a new stream, as the first INS_SIGN APDU does."""
+    library().btsPreviewBegin()
+
+
+def feed(chunk):
+    """
+    Ingests one APDU's worth of the TLV stream and returns STREAM_PROCESSING,
+    STREAM_FINISHED or STREAM_FAULT, as the device's parser would.  Once
+    finished, result() gives the Preview.
+    """
+    chunk = bytes(chunk)
+    return library().btsPreviewFeed(chunk, len(chunk))
+
+
+def preview(tlv):
+    """
+    Parses `tlv` (the INS_SIGN payload, as from encodeTlvTx) and returns a
+    Preview of (screens, txId, msgHash, unsupportedOps), where screens is a list
+    of (label, value) in display order and unsupportedOps lists the indices of
+    operations the device will show as "Unsupported".  Raises PreviewError if
+    the device would fault on the stream.
+    """
+    lib = library()
+    tlv = bytes(tlv)
+    status = lib.btsPreviewParse(tlv, len(tlv))
+    if status == STREAM_PROCESSING:
+        raise PreviewError("Transaction is truncated.")
+    if status != STREAM_FINISHED:
+        raise PreviewError("Transaction is malformed or exceeds device limits.")
+    return result()
+
+
+def result():
+    """
+    The Preview of the stream last parsed to STREAM_FINISHED, by preview() or
+    feed().  Raises PreviewError if the device could not display it.
+    """
+    lib = library()
+    msgHash = ctypes.create_string_buffer(32)
+    txId = ctypes.create_string_buffer(32)
+    lib.btsPreviewDigests(msgHash, txId)
+    unsupported = [i for i in range(lib.btsPreviewOperationCount())
+                   if not lib.btsPreviewOperationSupported(i)]
+
+    capacity = 64
+    while True:
+        screens = (_Screen * capacity)()
+        count = lib.btsPreviewRender(screens, capacity)
+        if count == 0:
+            raise PreviewError("Transaction cannot be displayed.")
+        if count <= capacity:
+            break
+        capacity = count
+    return Preview(screens=[(s.label.decode('utf-8', 'replace'), s.value.decode('utf-8', 'replace'))
+                            for s in screens[:count]],
+                   txId=txId.raw.hex(), msgHash=msgHash.raw.hex(),
+                   unsupportedOps=unsupported)
+
+
+if __name__ == '__main__':
+    import sys
+    for line in sys.stdin:
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            p = preview(bytes.fromhex(line))
+        except PreviewError as e:
+            print("REJECTED: %s" % e)
+            continue
+        for label, value in p.screens:
+            print("%-20s %s" % (label, value))
+        print()
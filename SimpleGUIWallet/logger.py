@@ -1,14 +1,24 @@
 ##
+## Activity log shown at the bottom of the wallet window.  Write() may be called
+## from RpcWorker threads; those messages are queued and shown by the main
+## thread, since Tk widgets must only be touched from there.
 ##
 
+import queue
+import threading
+
 class LoggerInstance:
     message_window = None
     message_body = ""
     mirror_to_stdout = False
+    pending = queue.Queue()
 
     def Write(self, msgtext, *, echo=None):
         if echo == True or (self.mirror_to_stdout==True and echo!=False):
             print(msgtext)
+        if threading.current_thread() is not threading.main_thread():
+            self.pending.put(msgtext)
+            return
         self.message_body += msgtext + "\n"
         self.message_window.configure(text=self.message_body)
         self.message_window.update()
@@ -20,5 +30,16 @@ class LoggerInstance:
 
     def SetMessageWidget(self, msgbox):
         self.message_window = msgbox
+        self.message_window.after(100, self.drainPending)
+
+    def drainPending(self):
+        while True:
+            try:
+                msgtext = self.pending.get_nowait()
+            except queue.Empty:
+                break
+            self.message_body += msgtext + "\n"
+            self.message_window.configure(text=self.message_body)
+        self.message_window.after(100, self.drainPending)
 
 Logger = LoggerInstance()
@@ -0,0 +1,208 @@
+##
+## On-disk cache of chain metadata the wallet looks up over and over: account
+## name <-> id, asset symbol -> id and precision, block number -> time,
+## per-account operation history, and, for account discovery, public keys per
+## device and derivation path and the accounts that reference each key.
+##
+## Backed by SQLite, so it persists across runs.  Account and asset entries
+## expire after a TTL (names and symbols are effectively permanent on chain, so
+## the TTLs are generous; they mainly bound how long a stale entry from a
+## different network could linger).  Block times never change and do not expire.
+## Key references expire quickly, since they change whenever an account's
+## authorities do.  Derived keys never change for a given device seed, which is
+## identified by a fingerprint key.  Account history is append-only on chain; each account's cached history is
+## kept contiguous from its newest entry down (see putHistory()).
+## Entries are keyed by chain id, so test-net and main-net don't mix.
+##
+## Safe to share between the Tk thread and the RpcWorker thread.
+##
+
+import json
+import os
+import sqlite3
+import threading
+import time
+
+DEFAULT_PATH = os.path.join(os.path.expanduser("~"), ".SimpleGUIWallet", "metadata.sqlite")
+ACCOUNT_TTL = 30 * 24 * 3600
+ASSET_TTL = 7 * 24 * 3600
+KEY_REFS_TTL = 3600
+
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS accounts (
+    chain TEXT NOT NULL, id TEXT NOT NULL, name TEXT NOT NULL, fetched REAL NOT NULL,
+    PRIMARY KEY (chain, id));
+CREATE UNIQUE INDEX IF NOT EXISTS accounts_by_name ON accounts (chain, name);
+CREATE TABLE IF NOT EXISTS assets (
+    chain TEXT NOT NULL, id TEXT NOT NULL, symbol TEXT NOT NULL, precision INTEGER NOT NULL,
+    fetched REAL NOT NULL,
+    PRIMARY KEY (chain, id));
+CREATE UNIQUE INDEX IF NOT EXISTS assets_by_symbol ON assets (chain, symbol);
+CREATE TABLE IF NOT EXISTS block_times (
+    chain TEXT NOT NULL, block_num INTEGER NOT NULL, time TEXT NOT NULL,
+    PRIMARY KEY (chain, block_num));
+CREATE TABLE IF NOT EXISTS device_keys (
+    device TEXT NOT NULL, path TEXT NOT NULL, key TEXT NOT NULL,
+    PRIMARY KEY (device, path));
+CREATE TABLE IF NOT EXISTS key_refs (
+    chain TEXT NOT NULL, key TEXT NOT NULL, accounts TEXT NOT NULL, fetched REAL NOT NULL,
+    PRIMARY KEY (chain, key));
+CREATE TABLE IF NOT EXISTS history (
+    chain TEXT NOT NULL, account TEXT NOT NULL, op INTEGER NOT NULL, item TEXT NOT NULL,
+    PRIMARY KEY (chain, account, op));
+"""
+
+
+class MetadataCache:
+
+    def __init__(self, chain_id, path=DEFAULT_PATH, account_ttl=ACCOUNT_TTL, asset_ttl=ASSET_TTL,
+                 key_refs_ttl=KEY_REFS_TTL):
+        if path != ":memory:":
+            os.makedirs(os.path.dirname(path), exist_ok=True)
+        self.chain = chain_id
+        self.account_ttl = account_ttl
+        self.asset_ttl = asset_ttl
+        self.key_refs_ttl = key_refs_ttl
+        self.lock = threading.Lock()
+        self.db = sqlite3.connect(path, check_same_thread=False)
+        with self.lock, self.db:
+            self.db.executescript(SCHEMA)
+
+    def close(self):
+        with self.lock:
+            self.db.close()
+
+    def _fresh(self, fetched, ttl):
+        return time.time() - fetched < ttl
+
+    ## Accounts:
+
+    def getAccount(self, name_or_id):
+        """Returns {'id', 'name'}, or None if not cached or expired."""
+        column = "id" if name_or_id.startswith("1.2.") else "name"
+        with self.lock:
+            row = self.db.execute("SELECT id, name, fetched FROM accounts WHERE chain=? AND %s=?"
+                                  % column, (self.chain, name_or_id)).fetchone()
+        if row is None or not self._fresh(row[2], self.account_ttl):
+            return None
+        return {'id': row[0], 'name': row[1]}
+
+    def putAccount(self, account_id, name):
+        with self.lock, self.db:
+            self.db.execute("DELETE FROM accounts WHERE chain=? AND name=? AND id!=?",
+                            (self.chain, name, account_id))
+            self.db.execute("INSERT OR REPLACE INTO accounts VALUES (?, ?, ?, ?)",
+                            (self.chain, account_id, name, time.time()))
+
+    ## Assets:
+
+    def getAsset(self, symbol_or_id):
+        """Returns {'id', 'symbol', 'precision'}, or None if not cached or expired."""
+        column = "id" if symbol_or_id.startswith("1.3.") else "symbol"
+        with self.lock:
+            row = self.db.execute("SELECT id, symbol, precision, fetched FROM assets WHERE chain=? AND %s=?"
+                                  % column, (self.chain, symbol_or_id)).fetchone()
+        if row is None or not self._fresh(row[3], self.asset_ttl):
+            return None
+        return {'id': row[0], 'symbol': row[1], 'precision': row[2]}
+
+    def putAsset(self, asset_id, symbol, precision):
+        with self.lock, self.db:
+            self.db.execute("DELETE FROM assets WHERE chain=? AND symbol=? AND id!=?",
+                            (self.chain, symbol, asset_id))
+            self.db.execute("INSERT OR REPLACE INTO assets VALUES (?, ?, ?, ?, ?)",
+                            (self.chain, asset_id, symbol, precision, time.time()))
+
+    def assets(self):
+        """
+        All unexpired cached assets, as a list of {'id', 'symbol', 'precision'}
+        ordered by asset id; e.g. for provisioning asset metadata to a device.
+        """
+        with self.lock:
+            rows = self.db.execute("SELECT id, symbol, precision, fetched FROM assets WHERE chain=?",
+                                   (self.chain,)).fetchall()
+        rows = [r for r in rows if self._fresh(r[3], self.asset_ttl)]
+        rows.sort(key=lambda r: int(r[0].split('.')[2]))
+        return [{'id': r[0], 'symbol': r[1], 'precision': r[2]} for r in rows]
+
+    ## Block times:
+
+    def getBlockTime(self, block_num):
+        with self.lock:
+            row = self.db.execute("SELECT time FROM block_times WHERE chain=? AND block_num=?",
+                                  (self.chain, block_num)).fetchone()
+        return row[0] if row is not None else None
+
+    def putBlockTime(self, block_num, block_time):
+        with self.lock, self.db:
+            self.db.execute("INSERT OR REPLACE INTO block_times VALUES (?, ?, ?)",
+                            (self.chain, block_num, block_time))
+
+    ## Device keys and key references, for account discovery:
+
+    def getDeviceKey(self, device, path):
+        with self.lock:
+            row = self.db.execute("SELECT key FROM device_keys WHERE device=? AND path=?",
+                                  (device, path)).fetchone()
+        return row[0] if row is not None else None
+
+    def putDeviceKey(self, device, path, key):
+        with self.lock, self.db:
+            self.db.execute("INSERT OR REPLACE INTO device_keys VALUES (?, ?, ?)", (device, path, key))
+
+    def getKeyReferences(self, key):
+        """Returns the list of account ids referencing `key`, or None if not cached or expired."""
+        with self.lock:
+            row = self.db.execute("SELECT accounts, fetched FROM key_refs WHERE chain=? AND key=?",
+                                  (self.chain, key)).fetchone()
+        if row is None or not self._fresh(row[1], self.key_refs_ttl):
+            return None
+        return json.loads(row[0])
+
+    def putKeyReferences(self, key, account_ids):
+        with self.lock, self.db:
+            self.db.execute("INSERT OR REPLACE INTO key_refs VALUES (?, ?, ?, ?)",
+                            (self.chain, key, json.dumps(account_ids), time.time()))
+
+    ## Account history.  Entries are the dicts from get_account_history, keyed
+    ## by the instance number of their "1.11.x" operation id.
+
+    @staticmethod
+    def opInstance(item):
+        return int(item['id'].split('.')[2])
+
+    def newestHistoryOp(self, account_id):
+        with self.lock:
+            row = self.db.execute("SELECT MAX(op) FROM history WHERE chain=? AND account=?",
+                                  (self.chain, account_id)).fetchone()
+        return row[0]
+
+    def oldestHistoryOp(self, account_id):
+        with self.lock:
+            row = self.db.execute("SELECT MIN(op) FROM history WHERE chain=? AND account=?",
+                                  (self.chain, account_id)).fetchone()
+        return row[0]
+
+    def getHistory(self, account_id, limit, before=None):
+        """Up to `limit` cached entries, newest first, older than op `before` if given."""
+        with self.lock:
+            rows = self.db.execute("SELECT item FROM history WHERE chain=? AND account=? AND op<? "
+                                   "ORDER BY op DESC LIMIT ?",
+                                   (self.chain, account_id,
+                                    before if before is not None else 2**62, limit)).fetchall()
+        return [json.loads(r[0]) for r in rows]
+
+    def putHistory(self, account_id, items):
+        """
+        Adds entries.  The caller must only add entries adjacent to what is
+        cached (newer than newest, or older than oldest, with no gap), or call
+        clearHistory() first, so that the cache is always contiguous.
+        """
+        with self.lock, self.db:
+            self.db.executemany("INSERT OR REPLACE INTO history VALUES (?, ?, ?, ?)",
+                                [(self.chain, account_id, self.opInstance(item), json.dumps(item))
+                                 for item in items])
+
+    def clearHistory(self, account_id):
+        with self.lock, self.db:
+            self.db.execute("DELETE FROM history WHERE chain=? AND account=?", (self.chain, account_id))
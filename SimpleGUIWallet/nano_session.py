@@ -0,0 +1,131 @@
+##
+## Long-lived device session for talking to the BitShares app on the Nano.
+##
+## Opening the HID transport costs hundreds of milliseconds, so rather than
+## getDongle() for every request, we open once and reuse the transport until it
+## fails.  App readiness is checked once per connection with
+## INS_GET_APP_CONFIGURATION.  If the transport drops (device unplugged, app
+## restarted) we reconnect on the next request.
+##
+## Used by SimpleGUIWallet and by the top-level scripts, so this module does not
+## write to the GUI Logger; errors are raised for the caller to report.
+##
+
+from ledgerblue.comm import getDongle
+from ledgerblue.commException import CommException
+
+CLA = 0xB5
+INS_GET_PUBLIC_KEY = 0x02
+INS_SIGN = 0x04
+INS_GET_APP_CONFIGURATION = 0x06
+
+SW_INS_NOT_SUPPORTED = 0x6D00
+SW_CLA_NOT_SUPPORTED = 0x6E00   # Usually means BitShares app not open on device
+
+
+class AppNotReadyException(Exception):
+    """The device is connected, but the BitShares app isn't running on it."""
+    pass
+
+
+class NanoSession:
+
+    def __init__(self, debug=False):
+        self.debug = debug
+        self.dongle = None
+        self.appConfig = None       # (dataAllowed, (major, minor, patch)) once ready
+
+    def isOpen(self):
+        return self.dongle is not None
+
+    def open(self):
+        """
+        Opens the transport and checks the app is running, if not already done.
+        Raises CommException if no device is found, or AppNotReadyException if
+        the BitShares app is not open.
+        """
+        if self.dongle is None:
+            self.dongle = getDongle(self.debug)
+            self.appConfig = None
+        if self.appConfig is None:
+            try:
+                result = self.dongle.exchange(bytes([CLA, INS_GET_APP_CONFIGURATION, 0, 0, 0]))
+            except CommException as e:
+                if e.sw in (SW_CLA_NOT_SUPPORTED, SW_INS_NOT_SUPPORTED):
+                    raise AppNotReadyException("BitShares app not running on Nano.") from e
+                raise
+            except Exception:
+                self.close()
+                raise
+            self.appConfig = (result[0] != 0, (result[1], result[2], result[3]))
+        return self
+
+    def close(self):
+        if self.dongle is not None:
+            try:
+                self.dongle.close()
+            except Exception:
+                pass
+        self.dongle = None
+        self.appConfig = None
+
+    def appVersion(self):
+        self.open()
+        return "%d.%d.%d" % self.appConfig[1]
+
+    def exchange(self, apdu, reconnect=True):
+        """
+        Sends one APDU and returns the response data.  Status-word errors
+        (CommException with .sw set, e.g. user declined) are raised as-is and
+        leave the session open.  Transport errors close the session; if
+        `reconnect` is True we then reopen and retry once.  Pass reconnect=False
+        for APDUs that continue a multi-APDU exchange, since the device will
+        have lost its state across a reconnect.
+        """
+        self.open()
+        try:
+            return self.dongle.exchange(apdu)
+        except CommException as e:
+            if e.sw == SW_CLA_NOT_SUPPORTED:
+                self.appConfig = None   # App was closed; recheck next time
+            raise
+        except Exception:
+            self.close()
+            if not reconnect:
+                raise
+        self.open()
+        return self.dongle.exchange(apdu)
+
+    def getAddress(self, donglePath, confirm=False):
+        """
+        Returns the BTS address (public key) string at `donglePath` (as from
+        parse_bip32_path).  With `confirm`, the user is asked to confirm it on
+        the device first.
+        """
+        apdu = bytes([CLA, INS_GET_PUBLIC_KEY, 0x01 if confirm else 0x00, 0x00,
+                      len(donglePath) + 1, len(donglePath) // 4]) + donglePath
+        result = self.exchange(apdu)
+        offset = 1 + result[0]
+        return bytes(result[offset + 1: offset + 1 + result[offset]]).decode("utf-8")
+
+    def __enter__(self):
+        return self.open()
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+        return False
+
+
+_session = None
+
+def getNanoSession(debug=False):
+    """Returns the process-wide session, creating it (but not opening it) if needed."""
+    global _session
+    if _session is None:
+        _session = NanoSession(debug)
+    return _session
+
+def closeNanoSession():
+    global _session
+    if _session is not None:
+        _session.close()
@@ -0,0 +1,78 @@
+##
+## Background task queue for blockchain RPC calls, so the Tk main thread never
+## blocks on a slow API node.
+##
+## Jobs run on worker threads.  Their results (or exceptions) are handed back to
+## the main thread by a poll loop scheduled with `after()`, and callbacks run
+## there, where it is safe to touch widgets and Tk variables.  Jobs submitted
+## under a key that is already in flight are merged: the job runs once and every
+## submitter's callbacks receive the result.
+##
+## A BitShares instance talks over a single websocket and is not safe for
+## concurrent use, so by default there is one worker thread and jobs run in
+## submission order.
+##
+
+import queue
+import sys
+import traceback
+from concurrent.futures import ThreadPoolExecutor
+
+
+class RpcWorker:
+
+    def __init__(self, tkroot, max_workers=1, poll_ms=50):
+        self.root = tkroot
+        self.poll_ms = poll_ms
+        self.executor = ThreadPoolExecutor(max_workers=max_workers, thread_name_prefix="rpc")
+        self.results = queue.Queue()
+        self.inflight = {}      # key -> [(on_done, on_error), ...]; main thread only
+        self.root.after(self.poll_ms, self._poll)
+
+    def submit(self, key, fn, *args, on_done=None, on_error=None, **kwargs):
+        """
+        Runs fn(*args, **kwargs) on a worker thread, then calls on_done(result)
+        or on_error(exception) on the main thread.  `key` identifies the query
+        for merging duplicates; pass None for a job that must always run (e.g.
+        a broadcast).  Returns False if merged into a job already in flight.
+        """
+        callbacks = (on_done, on_error)
+        if key is not None and key in self.inflight:
+            self.inflight[key].append(callbacks)
+            return False
+        if key is None:
+            key = object()
+        self.inflight[key] = [callbacks]
+        self.executor.submit(self._run, key, fn, args, kwargs)
+        return True
+
+    def isBusy(self, key=None):
+        return (key in self.inflight) if key is not None else bool(self.inflight)
+
+    def shutdown(self):
+        self.executor.shutdown(wait=False)
+
+    def _run(self, key, fn, args, kwargs):
+        try:
+            self.results.put((key, True, fn(*args, **kwargs)))
+        except Exception as e:
+            self.results.put((key, False, e))
+
+    def _poll(self):
+        while True:
+            try:
+                key, ok, value = self.results.get_nowait()
+            except queue.Empty:
+                break
+            for on_done, on_error in self.inflight.pop(key, []):
+                try:
+                    if ok and on_done is not None:
+                        on_done(value)
+                    elif not ok and on_error is not None:
+                        on_error(value)
+                    elif not ok:
+                        traceback.print_exception(type(value), value, value.__traceback__,
+                                                  file=sys.stderr)
+                except Exception:
+                    traceback.print_exc()
+        self.root.after(self.poll_ms, self._poll)
@@ -0,0 +1,159 @@
+##
+## Encodes a transaction into the flat TLV stream the BitShares app expects for
+## INS_SIGN: a sequence of DER OctetString fields,
+##
+##   [chain id][ref_block_num][ref_block_prefix][expiration]
+##   [op count]([op id][op payload])...[extensions]
+##
+## Replaces the generic asn1.Encoder.  Field payloads are gathered in a single pass
+## over the operations list, the exact output size is computed, and everything is
+## written into one preallocated bytearray.
+##
+## Run this module directly for a benchmark against asn1.Encoder (if installed)
+## on large synthetic transactions.
+##
+
+OCTET_STRING = 0x04
+
+
+def varint(n):
+    out = bytearray()
+    while True:
+        b = n & 0x7f
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def derHeaderLength(length):
+    if length < 0x80:
+        return 2
+    return 2 + (length.bit_length() + 7) // 8
+
+
+def writeDerHeader(buf, pos, length):
+    buf[pos] = OCTET_STRING
+    if length < 0x80:
+        buf[pos + 1] = length
+        return pos + 2
+    nbytes = (length.bit_length() + 7) // 8
+    buf[pos + 1] = 0x80 | nbytes
+    buf[pos + 2:pos + 2 + nbytes] = length.to_bytes(nbytes, 'big')
+    return pos + 2 + nbytes
+
+
+def encodeTlvFields(fields):
+    """Encodes a list of bytes-like field values as consecutive OctetString TLVs."""
+    total = sum(derHeaderLength(len(f)) + len(f) for f in fields)
+    buf = bytearray(total)
+    pos = 0
+    for f in fields:
+        pos = writeDerHeader(buf, pos, len(f))
+        buf[pos:pos + len(f)] = f
+        pos += len(f)
+    return buf
+
+
+OP_PROPOSAL_CREATE = 22
+
+
+def operationFields(op):
+    """
+    TLV field values for one bitsharesbase Operation: its id, then its payload.
+    The device reads a proposal_create as the fields before proposed_ops, the
+    op count, the id and payload of each proposed op, and the fields after
+    (see TLV_OP_COMPLEX in src/bts_stream.h).  Ops proposed within a proposed
+    op stay whole.  Either way the field values concatenate to the serialized
+    op, which is what gets hashed.
+    """
+    if op.opId != OP_PROPOSAL_CREATE:
+        return [varint(op.opId), bytes(op.op)]
+    data = op.op.data
+    proposed = data['proposed_ops'].data
+    fields = [varint(op.opId),
+              bytes(data['fee']) + bytes(data['fee_paying_account']) + bytes(data['expiration_time']),
+              varint(len(proposed))]
+    for wrapper in proposed:
+        inner = wrapper.data['op']
+        fields += [varint(inner.opId), bytes(inner.op)]
+    fields.append(bytes(data['review_period_seconds']) + bytes(data['extensions']))
+    assert b''.join(fields[1:]) == bytes(op.op), "proposal_create split does not match its serialization"
+    return fields
+
+
+def encodeTlvTx(chain_id, tx):
+    """
+    `chain_id` is the raw 32-byte chain id; `tx` is a bitsharesbase
+    Signed_Transaction.  Returns the TLV stream as a bytearray.
+    """
+    ops = tx['operations'].data
+    fields = [
+        chain_id,
+        bytes(tx['ref_block_num']),
+        bytes(tx['ref_block_prefix']),
+        bytes(tx['expiration']),
+        varint(len(ops)),
+    ]
+    for op in ops:
+        fields += operationFields(op)
+    fields.append(bytes(tx['extensions']))     # Serialized set; the device accepts only empty
+    return encodeTlvFields(fields)
+
+
+if __name__ == '__main__':
+    import argparse
+    import struct
+    import timeit
+    from bitsharesbase.signedtransactions import Signed_Transaction
+
+    parser = argparse.ArgumentParser(description="Benchmark TLV encoding of synthetic transactions.")
+    parser.add_argument('--ops', type=int, nargs='+', default=[1, 10, 100, 1000], help="op counts to try")
+    parser.add_argument('--repeat', type=int, default=20, help="encodings per measurement")
+    args = parser.parse_args()
+
+    try:
+        from asn1 import Encoder, Numbers
+    except ImportError:
+        Encoder = None
+
+    def encodeAsn1(chain_id, tx):
+        # The encoder this module replaced, verbatim, for comparison.
+        encoder = Encoder()
+        encoder.start()
+        encoder.write(struct.pack(str(len(chain_id)) + 's', chain_id), Numbers.OctetString)
+        encoder.write(bytes(tx['ref_block_num']), Numbers.OctetString)
+        encoder.write(bytes(tx['ref_block_prefix']), Numbers.OctetString)
+        encoder.write(bytes(tx['expiration']), Numbers.OctetString)
+        encoder.write(bytes(tx['operations'].length), Numbers.OctetString)
+        for opIdx in range(0, len(tx.toJson()['operations'])):
+            encoder.write(bytes([tx['operations'].data[opIdx].opId]), Numbers.OctetString)
+            encoder.write(bytes(tx['operations'].data[opIdx].op), Numbers.OctetString)
+        encoder.write(bytes([0]), Numbers.OctetString)
+        return encoder.output()
+
+    chain_id = bytes.fromhex("4018d7844c78f6a6c41c6a552b898022310fc5dec06da467ee7905a8dad512c8")
+    transfer = [0, {
+        "fee": {"amount": 10940, "asset_id": "1.3.0"},
+        "from": "1.2.1152620",
+        "to": "1.2.1152699",
+        "amount": {"amount": 1000000, "asset_id": "1.3.121"},
+        "extensions": []
+    }]
+
+    print("%8s %10s %14s %14s" % ("ops", "bytes", "native ms", "asn1 ms"))
+    for nops in args.ops:
+        tx = Signed_Transaction(ref_block_num=18714, ref_block_prefix=966826885,
+                                expiration="2018-12-08T03:37:57",
+                                operations=[transfer] * nops)
+        out = encodeTlvTx(chain_id, tx)
+        native = timeit.timeit(lambda: encodeTlvTx(chain_id, tx), number=args.repeat)
+        if Encoder is not None:
+            assert bytes(out) == encodeAsn1(chain_id, tx), "Encoders disagree"
+            legacy = "%14.3f" % (timeit.timeit(lambda: encodeAsn1(chain_id, tx), number=args.repeat)
+                                 * 1000 / args.repeat)
+        else:
+            legacy = "%14s" % "(no asn1)"
+        print("%8d %10d %14.3f %s" % (nops, len(out), native * 1000 / args.repeat, legacy))
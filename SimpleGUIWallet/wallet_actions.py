@@ -2,18 +2,23 @@ from bitshares import BitShares
 from bitsharesbase import operations
 from bitsharesbase.signedtransactions import Signed_Transaction
 from bitshares.account import Account
-from bitshares.amount import Amount
 from bitshares.asset import Asset
 from bitshares.memo import Memo
+from bitsharesbase.account import PublicKey
 from graphenecommon.exceptions import AccountDoesNotExistsException
 from graphenecommon.exceptions import AssetDoesNotExistsException
 from grapheneapi.exceptions import RPCError
 from grapheneapi.exceptions import NumRetriesReached
-from ledgerblue.comm import getDongle
 from ledgerblue.commException import CommException
-from asn1 import Encoder, Numbers
+from nano_session import getNanoSession, AppNotReadyException
+from apdu_chunking import chunkTxForSigning, sendSignApdus, chunkMemoForEncryption
+from tlv_encoder import encodeTlvTx
+import device_preview
+from metadata_cache import MetadataCache, DEFAULT_PATH as METADATA_CACHE_PATH
+from account_discovery import AccountDiscovery, DEFAULT_GAP_LIMIT
 from datetime import datetime, timedelta
 import binascii
+import os
 import struct
 import json
 from logger import Logger
@@ -23,15 +28,53 @@ from logger import Logger
 from bitshares.block import Block, BlockHeader
 from bitsharesbase.operations import getOperationNameForId
 
+metadata = None     # MetadataCache, once initBlockchainObject() has run
 
-def initBlockchainObject(api_node):
-    global blockchain
+
+def initBlockchainObject(api_node, cache_path=METADATA_CACHE_PATH):
+    global blockchain, metadata
     try:
         blockchain = BitShares(api_node, num_retries=0)
-        return blockchain
     except:
         print("ERROR: Could not connect to API node at %s" % api_node)
         exit()
+    metadata = None
+    if cache_path:
+        try:
+            metadata = MetadataCache(blockchain.rpc.chain_params['chain_id'], cache_path)
+        except Exception as e:
+            print("WARNING: Metadata cache unavailable (%s); continuing without it." % str(e))
+    return blockchain
+
+
+##
+# Account and asset lookups, through the metadata cache when we have one.
+# Raise AccountDoesNotExistsException/AssetDoesNotExistsException as the
+# bitshares objects do.
+def lookupAccount(name_or_id):
+    cached = metadata.getAccount(name_or_id) if metadata else None
+    if cached is not None:
+        return cached
+    account = fetchAccount(name_or_id)
+    return {'id': account['id'], 'name': account['name']}
+
+##
+# The full Account from the node, for what the cache doesn't hold (e.g. memo
+# keys, which change with account_update).  Caches its name and id on the way.
+def fetchAccount(name_or_id):
+    account = Account(name_or_id, blockchain_instance=blockchain)
+    if metadata:
+        metadata.putAccount(account['id'], account['name'])
+    return account
+
+def lookupAsset(symbol_or_id):
+    cached = metadata.getAsset(symbol_or_id) if metadata else None
+    if cached is not None:
+        return cached
+    asset = Asset(symbol_or_id, blockchain_instance=blockchain)
+    if metadata:
+        metadata.putAsset(asset['id'], asset['symbol'], asset['precision'])
+    return {'id': asset['id'], 'symbol': asset['symbol'], 'precision': asset['precision']}
 
 
 def parse_bip32_path(path):
@@ -61,17 +104,53 @@ def getHeadBlockBlankTx():
 
 
 
+##
+# Encrypts `memo_text` on the Nano, with the memo key at `memo_path`, from
+# public key `from_key` (the key at that path) to `to_key`.  Returns the memo
+# as a Transfer op takes it.  The memo key never leaves the device.
+def encryptMemoOnNano(memo_path, from_key, to_key, memo_text):
+    nonce = struct.unpack(">Q", os.urandom(8))[0]
+    recipient = bytes(PublicKey(to_key, prefix=blockchain.prefix))
+    apdus = chunkMemoForEncryption(memo_text.encode("utf-8"), parse_bip32_path(memo_path),
+                                   recipient, nonce)
+    session = getNanoSession(True)
+    try:
+        session.open()
+    except AppNotReadyException:
+        Logger.Write("BitShares App not running on Nano.  Please check.")
+        raise
+    except:
+        Logger.Write("Ledger Nano not found! Is it plugged in and unlocked?")
+        raise
+    message = b""
+    try:
+        for idx, apdu in enumerate(apdus):
+            message += bytes(session.exchange(apdu, reconnect=(idx == 0)))
+    except CommException as e:
+        Logger.Write("Nano could not encrypt memo (status %04x)." % e.sw)
+        raise
+    return {"from": from_key, "to": to_key, "nonce": str(nonce), "message": message.hex()}
+
 ##
 #  `builder` is a TransactionBuilder object. (E.g. from BitShares.new_tx())
 #  `dest_account_name` is a string account name.
-def appendTransferOpToTx(builder, from_name, to_name, amount, symbol):
+#  If `memo_path` is given, any memo is encrypted on the Nano with the memo key
+#  at that path, which must be `from_name`'s memo key.
+def appendTransferOpToTx(builder, from_name, to_name, amount, symbol, memo_path=None):
 
     ## TODO: Cleanup exception catching for better user feedback
 
+    memo_text = "" #"Signed by BitShares App on Ledger Nano S!"
     try:
-        account = Account(from_name, blockchain_instance=blockchain)
-        to = Account(to_name, blockchain_instance=blockchain)
-        amountAsset = Amount(amount, symbol, blockchain_instance=blockchain)
+        # A memo needs both parties' memo keys, which aren't cached, so then we
+        # fetch each account in full, once; otherwise the cache will do.
+        if memo_text:
+            account = fetchAccount(from_name)
+            to = fetchAccount(to_name)
+        else:
+            account = lookupAccount(from_name)
+            to = lookupAccount(to_name)
+        asset = lookupAsset(symbol)
     except NumRetriesReached:
         Logger.Write("ERROR: Can't reach API node: 'NumRetries' reached.  Check network connection.")
         raise
@@ -85,16 +164,21 @@ def appendTransferOpToTx(builder, from_name, to_name, amount, symbol):
         Logger.Write("Unknown problem constructing Transfer operation: %s"%str(e))
         raise
 
-    memoObj = Memo(from_account=account, to_account=to, blockchain_instance=blockchain)
-    memo_text = "" #"Signed by BitShares App on Ledger Nano S!"
+    memo = None
+    if memo_text and memo_path:
+        memo = encryptMemoOnNano(memo_path, account["options"]["memo_key"],
+                                 to["options"]["memo_key"], memo_text)
+    elif memo_text:
+        memoObj = Memo(from_account=account, to_account=to, blockchain_instance=blockchain)
+        memo = memoObj.encrypt(memo_text)
 
     op = operations.Transfer(
         **{
             "fee": {"amount": 0, "asset_id": "1.3.0"},
             "from": account["id"],
             "to": to["id"],
-            "amount": {"amount": int(amountAsset), "asset_id": amountAsset.asset["id"]},
-            "memo": memoObj.encrypt(memo_text),
+            "amount": {"amount": int(amount * 10 ** asset["precision"]), "asset_id": asset["id"]},
+            "memo": memo,
         }
     )
 
@@ -126,70 +210,54 @@ def getSerializedTxBytes(tx_json):
 
 ##
 #
-def encodeTlvTx(chain_id, tx):
-
-    encoder = Encoder()
-    encoder.start()
-
-    encoder.write(struct.pack(str(len(chain_id)) + 's', chain_id), Numbers.OctetString)
-    encoder.write(bytes(tx['ref_block_num']), Numbers.OctetString)
-    encoder.write(bytes(tx['ref_block_prefix']), Numbers.OctetString)
-    encoder.write(bytes(tx['expiration']), Numbers.OctetString)
-    encoder.write(bytes(tx['operations'].length), Numbers.OctetString)
-    for opIdx in range(0, len(tx.toJson()['operations'])):
-        encoder.write(bytes([tx['operations'].data[opIdx].opId]), Numbers.OctetString)
-        encoder.write(bytes(tx['operations'].data[opIdx].op), Numbers.OctetString)
-
-    if 'extension' in tx:
-        encoder.write(bytes(tx['extension']), Numbers.OctetString)
-    else:
-        encoder.write(bytes([0]), Numbers.OctetString)
-
-    return encoder.output()
+def previewOnHost(serial_tx_bytes):
+    # Shows the screens the Nano will display, as rendered by the app's own
+    # parser built for the host, and refuses locally what the Nano would refuse.
+    # Skipped if host/libbtspreview.so hasn't been built.
+    if not device_preview.isAvailable():
+        return
+    try:
+        p = device_preview.preview(serial_tx_bytes)
+    except device_preview.PreviewError as e:
+        Logger.Write("ERROR: Nano would reject transaction: %s  Not sent for signing." % str(e))
+        raise
+    if p.unsupportedOps:
+        Logger.Write("ERROR: Nano cannot display operation(s) %s of this transaction.  Not sent for signing."
+                     % ", ".join(str(i + 1) for i in p.unsupportedOps))
+        raise device_preview.PreviewError("Unsupported operation")
+    Logger.Write("Nano will display:")
+    for label, value in p.screens:
+        Logger.Write("    %s: %s" % (label, value))
 
 ##
 #
 def getSignatureFromNano(serial_tx_bytes, bip32_path):
     donglePath = parse_bip32_path(bip32_path)
-    pathSize = int(len(donglePath) / 4)
+    apdus = chunkTxForSigning(serial_tx_bytes, donglePath)
+    previewOnHost(serial_tx_bytes)
+    session = getNanoSession(True)
     try:
-        dongle = getDongle(True)
+        session.open()
+    except AppNotReadyException:
+        Logger.Write("BitShares App not running on Nano.  Please check.")
+        raise
     except:
         Logger.Write("Ledger Nano not found! Is it plugged in and unlocked?")
         raise
     Logger.Write("Please review and confirm transaction on Ledger Nano S...")
-    offset = 0
-    first = True
-    signSize = len(serial_tx_bytes)
-    while offset != signSize:
-        if signSize - offset > 200:
-            chunk = serial_tx_bytes[offset: offset + 200]
-        else:
-            chunk = serial_tx_bytes[offset:]
-
-        if first:
-            totalSize = len(donglePath) + 1 + len(chunk)
-            apdu = binascii.unhexlify("B5040000" + "{:02x}".format(totalSize) + "{:02x}".format(pathSize)) + donglePath + chunk
-            first = False
+    try:
+        result, stats = sendSignApdus(session, apdus)
+    except CommException as e:
+        if e.sw == 0x6e00:
+            Logger.Write("BitShares App not running on Nano.  Please check.")
         else:
-            totalSize = len(chunk)
-            apdu = binascii.unhexlify("B5048000" + "{:02x}".format(totalSize)) + chunk
-
-        offset += len(chunk)
-        try:
-            result = dongle.exchange(apdu)
-        except CommException as e:
-            dongle.close()
-            if e.sw == 0x6e00:
-                Logger.Write("BitShares App not running on Nano.  Please check.")
-            else:
-                Logger.Write("User declined - transaction not signed.")
-            raise
-        except:
-            dongle.close()
-            Logger.Write("An unknown error occured.  Was device unplugged?")
-            raise
-    dongle.close()
+            Logger.Write("User declined - transaction not signed.")
+        raise
+    except:
+        Logger.Write("An unknown error occured.  Was device unplugged?")
+        raise
+    print("Signed %d tx bytes in %d APDUs; %.2f s including user review."
+          % (len(serial_tx_bytes), stats.apduCount, stats.seconds))
     return result
 
 def broadcastTxWithProvidedSignature(tx_json, sig_bytes):
@@ -214,8 +282,12 @@ def getPublicKeyListFromNano(bip32_paths, confirm_on_device = False):
     # list if we don't suceed in retrieving all keys. To determine success or
     # (partial) failure, compare length of return list to length of key list.
     Addresses = []
+    session = getNanoSession(True)
     try:
-        dongle = getDongle(True)
+        session.open()
+    except AppNotReadyException:
+        Logger.Write("BitShares App not running on Nano.  Please check.")
+        return []
     except:
         Logger.Write("Ledger Nano not found! Is it plugged in and unlocked?")
         return []
@@ -230,9 +302,8 @@ def getPublicKeyListFromNano(bip32_paths, confirm_on_device = False):
         ) + donglePath
 
         try:
-            result = dongle.exchange(apdu)
+            result = session.exchange(apdu)
         except CommException as e:
-            dongle.close()
             if e.sw == 0x6e00:
                 Logger.Write("BitShares App not running on Nano.  Please check.")
             elif e.sw == 0x6985:
@@ -242,7 +313,6 @@ def getPublicKeyListFromNano(bip32_paths, confirm_on_device = False):
                 Logger.Write("Warning! Address not confirmed by user, or other error.")
             return Addresses
         except Exception:
-            dongle.close()
             Logger.Write("An unknown error occured.  Was device unplugged?")
             return Addresses
 
@@ -253,10 +323,116 @@ def getPublicKeyListFromNano(bip32_paths, confirm_on_device = False):
 
         Addresses.append(address)
 
-    dongle.close()
     return Addresses
 
 
+HISTORY_PAGE = 40           # History entries fetched per page
+HISTORY_API_LIMIT = 100     # Max entries the node returns per get_account_history
+HISTORY_SYNC_MAX_PAGES = 10 # Beyond this many new entries, resync from scratch
+
+def fetchHistory(account_id, limit, start=0, stop=0):
+    """
+    Raw get_account_history: up to `limit` entries, newest first, with op
+    instance <= `start` (0 = most recent) and > `stop`.
+    """
+    return blockchain.rpc.get_account_history(account_id, "1.11.%d" % stop, limit,
+                                              "1.11.%d" % start, api="history")
+
+def syncAccountHistory(account_id, limit=HISTORY_PAGE):
+    """
+    Returns the newest `limit` history entries, newest first.  With the metadata
+    cache, only entries newer than the newest cached one are fetched.
+    """
+    if not metadata:
+        return fetchHistory(account_id, limit)
+    newest = metadata.newestHistoryOp(account_id)
+    if newest is None:
+        fresh = fetchHistory(account_id, limit)
+    else:
+        fresh = []
+        start = 0
+        for _ in range(HISTORY_SYNC_MAX_PAGES):
+            page = fetchHistory(account_id, HISTORY_API_LIMIT, start=start, stop=newest)
+            fresh.extend(page)
+            if len(page) < HISTORY_API_LIMIT:
+                break
+            start = metadata.opInstance(page[-1]) - 1
+        else:
+            # Too far behind to close the gap cheaply; start over.
+            metadata.clearHistory(account_id)
+            fresh = fetchHistory(account_id, limit)
+    metadata.putHistory(account_id, fresh)
+    return metadata.getHistory(account_id, limit)
+
+def getOlderHistory(account_id, before, limit=HISTORY_PAGE):
+    """
+    Returns up to `limit` entries older than op instance `before`, newest first,
+    from the cache where possible.  An empty list means the start of history.
+    """
+    items = metadata.getHistory(account_id, limit, before=before) if metadata else []
+    if len(items) < limit:
+        # Continue from below the cache's oldest entry, so the cache stays contiguous.
+        oldest = metadata.opInstance(items[-1]) if items else before
+        if oldest > 1:
+            older = fetchHistory(account_id, limit - len(items), start=oldest - 1)
+            if metadata:
+                metadata.putHistory(account_id, older)
+            items.extend(older)
+    return items
+
+def historyLabels(items, account_id, resolve_times=3):
+    # Block times come from the cache where known, else are resolved over the
+    # network for the first `resolve_times` items only.
+    return [pprintHistoryItem(item, account_id, resolve_time=(idx < resolve_times))
+            for idx, item in enumerate(items)]
+
+def discoverAccountKeys(gap_limit=DEFAULT_GAP_LIMIT):
+    """
+    Scans SLIP-0048 paths on the Nano for keys referenced on chain.  Returns
+    (found, names): a list of DiscoveredKey, and a dict of account id to name
+    for the accounts referencing them.  Exceptions from device or node propagate.
+    """
+    session = getNanoSession(True)
+    def getKeys(paths):
+        return [session.getAddress(parse_bip32_path(path)) for path in paths]
+    def getKeyReferences(keys):
+        return blockchain.rpc.get_key_references(keys)
+    engine = AccountDiscovery(getKeys, getKeyReferences, cache=metadata,
+                              gap_limit=gap_limit, progress=Logger.Write)
+    found = engine.run()
+    names = {}
+    for discovered in found:
+        for account_id in discovered.accounts:
+            if account_id not in names:
+                names[account_id] = lookupAccount(account_id)['name']
+    Logger.Write("Discovery done: %d keys in use; %d keys from device, %d from cache; %d node lookups."
+                 % (len(found), engine.stats['deviceKeys'], engine.stats['cachedKeys'],
+                    engine.stats['chainLookups']))
+    return found, names
+
+def getAccountInfo(account_name, history_limit=HISTORY_PAGE, resolve_times=3):
+    """
+    Fetches everything the account panes show, in one go, so that it can be run
+    off the main thread.  Returns (balances, history, account_id, labels), where
+    labels are the pprintHistoryItem() strings for the history items, with block
+    times resolved for the most recent `resolve_times` of them.
+    """
+    try:
+        account = Account(account_name, blockchain_instance=blockchain)
+        balances = account.balances
+        account_id = account.identifier
+        history = syncAccountHistory(account_id, history_limit)
+    except AccountDoesNotExistsException:
+        Logger.Write("ERROR: Specified account does not exist on BitShares network.")
+        return [], [], "", []
+    if metadata:
+        # Warm the cache with what we just learned, so sends need no lookups.
+        metadata.putAccount(account['id'], account['name'])
+        for amount in balances:
+            metadata.putAsset(amount.asset['id'], amount.asset['symbol'], amount.asset['precision'])
+    return balances, history, account_id, historyLabels(history, account_id, resolve_times)
+
+
 def getTransactionFromHistoryItem(hist_item):
     block = Block(hist_item["block_num"], blockchain_instance=blockchain)
     trx = block.get("transactions")[hist_item["trx_in_block"]]
@@ -271,11 +447,15 @@ def pprintHistoryItem(item, selfId, resolve_time=True):
     as "receive" if selfId is the recipient or "send" if selfId is the sender,
     else the operation name is left as "transfer".
     """
-    block_time = "..."
-    if resolve_time:
+    block_time = metadata.getBlockTime(item["block_num"]) if metadata else None
+    if block_time is None and resolve_time:
         # Resolving time can be slow, as it waits on API call to retireve block header.
         block = BlockHeader(item["block_num"], blockchain_instance=blockchain)
-        block_time = block.time()
+        block_time = str(block.time())
+        if metadata:
+            metadata.putBlockTime(item["block_num"], block_time)
+    if block_time is None:
+        block_time = "..."
     if item['op'][0] == 0:
         if (item['op'][1]['to']==selfId) and (item['op'][1]['from']!=selfId):
             op_desc = "Receive"
@@ -244,14 +244,19 @@ class HistoryListFrame(ttk.Frame):
     def __init__(self, parent, *args, **kwargs):
 
         self.tx_json_tkvar = kwargs.pop('jsonvar', None)
+        self.load_more_command = kwargs.pop('loadmorecommand', None)
 
         ttk.Frame.__init__(self, parent, *args, **kwargs)
 
         self.HistItems = []
+        self.Labels = []
         self.accountId = ""
+        self.loadingMore = False    # An older page has been requested
+        self.atOldest = False       # No older history exists
 
         self.lst_assets = ScrolledListbox(self)
         self.lst_assets.pack(padx=2, pady=2, side="top", fill="both", expand=True)
+        self.lst_assets.config(yscrollcommand=self.on_yscroll)
 
         button_frame = ttk.Frame(self)
         button_frame.pack(expand=False, fill="x", side="top")
@@ -263,21 +268,62 @@ class HistoryListFrame(ttk.Frame):
 
         self.refresh()
 
-    def setHistory(self, HistList, accountId):
+    @staticmethod
+    def opInstance(item):
+        return int(item['id'].split('.')[2])
+
+    def setHistory(self, HistList, accountId, Labels=None):
         # HistList is an iterator over dict objects containing the operation wrapped in metadata
-        self.HistItems = []        # Let's make it into a proper list though.
+        # Labels, if given, are the pprintHistoryItem() strings, already resolved
+        # off the main thread; otherwise we resolve them here.
+        HistList = list(HistList)
+        if Labels is None:
+            Labels = [pprintHistoryItem(item, accountId, resolve_time=(idx < 3)) # API call.. slow
+                      for idx, item in enumerate(HistList)]
+        if accountId == self.accountId and self.HistItems:
+            # Same account: just put anything newer on top, and keep what the
+            # user has already paged in below.
+            newest = self.opInstance(self.HistItems[0])
+            fresh = [idx for idx, item in enumerate(HistList) if self.opInstance(item) > newest]
+            if len(fresh) < len(HistList):
+                self.HistItems[0:0] = [HistList[idx] for idx in fresh]
+                self.Labels[0:0] = [Labels[idx] for idx in fresh]
+                for idx in reversed(fresh):
+                    self.lst_assets.insert(0, Labels[idx])
+                return
+            # Else no overlap with what we show, so start over.
+        self.HistItems = HistList
+        self.Labels = list(Labels)
         self.accountId = accountId # Used to determine if history items are to/from
-        for item in HistList:
-            self.HistItems.append(item)
+        self.loadingMore = False
+        self.atOldest = False
         self.refresh()
 
+    def appendHistory(self, HistList, accountId, Labels):
+        # An older page, as requested through load_more_command.
+        self.loadingMore = False
+        if accountId != self.accountId:
+            return
+        if len(HistList) == 0:
+            self.atOldest = True
+            return
+        self.HistItems.extend(HistList)
+        self.Labels.extend(Labels)
+        for label in Labels:
+            self.lst_assets.insert(tk.END, label)
+
     def refresh(self):
         self.lst_assets.delete(0, tk.END)
-        count = 0
-        for item in self.HistItems:
-            resolve_time = (count < 3) # Limit how many we get full date for (API call.. slow)
-            self.lst_assets.insert(tk.END, pprintHistoryItem(item, self.accountId, resolve_time=resolve_time))
-            count+=1
+        for label in self.Labels:
+            self.lst_assets.insert(tk.END, label)
+
+    def on_yscroll(self, first, last):
+        self.lst_assets.v_scroll.set(first, last)
+        if (float(last) >= 1.0 and self.HistItems and self.load_more_command is not None
+                and not self.loadingMore and not self.atOldest):
+            # Bottom of list is in view; fetch the next older page.
+            self.loadingMore = True
+            self.load_more_command(self.accountId, self.opInstance(self.HistItems[-1]))
 
     def on_click_rawtx(self, *args):
         idx = self.lst_assets.index(self.lst_assets.curselection())
@@ -499,6 +545,7 @@ class QueryPublicKeysFrame(ttk.Frame):
     def __init__(self, parent, *args, **kwargs):
 
         self.lookup_command = kwargs.pop('lookupcommand', lambda *args, **kwargs: None)
+        self.discover_command = kwargs.pop('discovercommand', None)
         self.textvariable_path = kwargs.pop('textvar_bip32_path', None)
         self.textvariable_key = kwargs.pop('textvar_bip32_key', None)
 
@@ -510,6 +557,7 @@ class QueryPublicKeysFrame(ttk.Frame):
         self.ownerKeys = []
         self.activeKeys = []
         self.memoKeys = []
+        self.keyAccounts = {}   # key -> account names referencing it, from discovery
 
         self.accountIndex_var = tk.StringVar(self, value = "0'")
 
@@ -572,6 +620,13 @@ class QueryPublicKeysFrame(ttk.Frame):
         )
         self.button_get_addrs.pack(side="left")
 
+        self.button_discover = ttk.Button(frameButtons, text="Discover Accounts",
+                                     command=lambda: self.on_click_discover()
+        )
+        self.button_discover.pack(padx=(12,0), side="left")
+        if self.discover_command is None:
+            self.button_discover.configure(state="disabled")
+
         self.button_confirm_addr = ttk.Button(frameButtons, text="Confirm Address",
                                      command=lambda: self.on_click_confirm_addr()
         )
@@ -590,6 +645,8 @@ class QueryPublicKeysFrame(ttk.Frame):
         listbox.delete(0,tk.END)
         for idx in range(len(paths)):
             itemtext = "%s (%s)" % (paths[idx], keys[idx] if idx < len(keys) else "??")
+            if idx < len(keys) and keys[idx] in self.keyAccounts:
+                itemtext += " " + ", ".join(self.keyAccounts[keys[idx]])
             listbox.insert(tk.END, itemtext)
         listbox.insert(tk.END, "...")
 
@@ -610,6 +667,39 @@ class QueryPublicKeysFrame(ttk.Frame):
             self.button_get_addrs.configure(state="normal") # Return to enabled state
             Logger.Write("READY.")
 
+    def on_click_discover(self):
+        # Discovery runs in the background and talks to the Nano, so keep the
+        # other device buttons off until it reports back via setDiscovered().
+        for button in (self.button_discover, self.button_get_addrs, self.button_confirm_addr):
+            button.configure(state="disabled")
+        Logger.Clear()
+        Logger.Write("Discovering accounts: scanning Nano keys and looking them up on chain...")
+        self.discover_command()
+
+    def setDiscovered(self, found, names):
+        # `found` is a list of DiscoveredKey, or None if discovery failed.
+        for button in (self.button_discover, self.button_get_addrs, self.button_confirm_addr):
+            button.configure(state="normal")
+        if found is None:
+            return
+        self.keyAccounts = {}
+        paths = {'owner': [], 'active': [], 'memo': []}
+        keys = {'owner': [], 'active': [], 'memo': []}
+        for discovered in found:
+            paths[discovered.role].append(discovered.path)
+            keys[discovered.role].append(discovered.key)
+            self.keyAccounts[discovered.key] = [names.get(a, a) for a in discovered.accounts]
+        if not found:
+            Logger.Write("No keys on this Nano are referenced by any account.")
+            return
+        self.ownerPaths, self.ownerKeys = paths['owner'], keys['owner']
+        self.activePaths, self.activeKeys = paths['active'], keys['active']
+        self.memoPaths, self.memoKeys = paths['memo'], keys['memo']
+        self.refresh()
+        for discovered in found:
+            Logger.Write("  %-7s %s  %s" % (discovered.role, discovered.path,
+                                           ", ".join(self.keyAccounts[discovered.key])))
+
     def on_click_confirm_addr(self):
 
         self.button_confirm_addr.configure(state="disabled")
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+/*******************************************************************************
+*  Copyright of the Contributing Authors; see CONTRIBUTORS.md.
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+Finds which SLIP-0048 keys on the Nano are referenced by accounts on chain,
+walking owner, active and memo roles across account indices until a gap of
+unused keys (see SimpleGUIWallet/account_discovery.py).  Derived keys and key
+references are cached, so rescans are incremental:
+
+    python3 discoverAccounts.py --gap 5
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), 'SimpleGUIWallet'))
+from nano_session import NanoSession
+from account_discovery import AccountDiscovery, DEFAULT_GAP_LIMIT, DEFAULT_MAX_ACCOUNTS
+from metadata_cache import MetadataCache, DEFAULT_PATH as METADATA_CACHE_PATH
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return bytes([])
+    result = bytes([])
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--node', default='wss://bitshares.openledger.info/ws', help="API node to look up keys on")
+parser.add_argument('--gap', type=int, default=DEFAULT_GAP_LIMIT, help="consecutive unused keys ending a role's scan")
+parser.add_argument('--account-gap', type=int, default=1, help="consecutive unused account indices ending the scan")
+parser.add_argument('--max-accounts', type=int, default=DEFAULT_MAX_ACCOUNTS, help="highest account index to scan, plus one")
+parser.add_argument('--network', type=int, default=1, help="SLIP-0048 network index (1 = BitShares)")
+parser.add_argument('--cache', default=METADATA_CACHE_PATH, help="metadata cache file")
+parser.add_argument('--no-cache', action='store_true', help="don't use or update the metadata cache")
+parser.add_argument('--json', action='store_true', help="print results as JSON lines")
+args = parser.parse_args()
+
+from bitshares import BitShares
+blockchain = BitShares(args.node, num_retries=0)
+cache = None if args.no_cache else MetadataCache(blockchain.rpc.chain_params['chain_id'], args.cache)
+
+session = NanoSession(False).open()
+engine = AccountDiscovery(
+    lambda paths: [session.getAddress(parse_bip32_path(p)) for p in paths],
+    lambda keys: blockchain.rpc.get_key_references(keys),
+    cache=cache, gap_limit=args.gap, account_gap_limit=args.account_gap,
+    max_accounts=args.max_accounts, network=args.network,
+    progress=lambda message: print(message, file=sys.stderr))
+found = engine.run()
+session.close()
+
+names = {}
+if found:
+    ids = sorted(set(a for k in found for a in k.accounts))
+    for obj in blockchain.rpc.get_objects(ids):
+        names[obj['id']] = obj['name']
+
+for k in found:
+    accounts = [names.get(a, a) for a in k.accounts]
+    if args.json:
+        print(json.dumps({'role': k.role, 'path': k.path, 'key': k.key, 'accounts': accounts}))
+    else:
+        print("%-7s %-22s %s  %s" % (k.role, k.path, k.key, ", ".join(accounts)))
+print("%d keys in use.  Keys: %d from device, %d from cache.  Node lookups: %d (%d refs cached)."
+      % (len(found), engine.stats['deviceKeys'], engine.stats['cachedKeys'],
+         engine.stats['chainLookups'], engine.stats['cachedRefs']), file=sys.stderr)
@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+"""
+/*******************************************************************************
+*  Copyright of the Contributing Authors; see CONTRIBUTORS.md.
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+Generates synthetic transactions, pre-encoded in the TLV stream format that
+signTransaction.py sends to the Nano, with controlled shapes.  Intended as input
+for parse/display benchmarks, so that device-side cost can be charted against
+transaction size.
+
+Every shape option accepts a comma-separated list of values, and one transaction
+is generated for each combination (times --count).  E.g., to sweep op count and
+memo length:
+
+    python3 generateSyntheticTx.py --ops 1,2,4 --memo-len 0,64,256
+
+A proposal_create in the mix proposes --proposed ops, drawn from the rest of
+the mix, and is split into several TLV fields the way tlv_encoder.py does it.
+
+Payloads are serialized directly (no bitsharesbase) and filled with random
+data.  Public keys are random bytes, not valid curve points, which is fine for
+parsing but means the device will display nonsense addresses.
+"""
+
+import argparse
+import binascii
+import itertools
+import json
+import random
+import struct
+import sys
+
+CHAIN_ID_MAINNET = "4018d7844c78f6a6c41c6a552b898022310fc5dec06da467ee7905a8dad512c8"
+
+OP_IDS = {
+    'transfer': 0,
+    'limit_order_create': 1,
+    'limit_order_cancel': 2,
+    'call_order_update': 3,
+    'account_update': 6,
+    'account_upgrade': 8,
+    'proposal_create': 22,
+    'bid_collateral': 45,
+}
+
+# Device-side limits (see src/bts_stream.h), reported so oversize shapes are obvious:
+DEVICE_MAX_OPERATIONS = 4
+DEVICE_OP_DATA_BUFFER = 768
+
+def varint(n):
+    out = bytearray()
+    while True:
+        b = n & 0x7f
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+def der_octet_string(data):
+    if len(data) < 0x80:
+        header = bytes([0x04, len(data)])
+    else:
+        lenbytes = len(data).to_bytes((len(data).bit_length() + 7) // 8, 'big')
+        header = bytes([0x04, 0x80 | len(lenbytes)]) + lenbytes
+    return header + data
+
+class Generator:
+    """Builds serialized op payloads from random data, within the given shape."""
+
+    def __init__(self, rng, shape):
+        self.rng = rng
+        self.shape = shape
+
+    def object_id(self):
+        # Pick an instance id whose varint encoding is exactly id_bytes long.
+        nbytes = self.shape['id_bytes']
+        low = 0 if nbytes == 1 else 1 << (7 * (nbytes - 1))
+        high = min((1 << (7 * nbytes)), 1 << 48) - 1    # Instance ids are 48 bits
+        return self.rng.randint(low, high)
+
+    def asset(self):
+        return struct.pack('<q', self.rng.randint(1, 10**12)) + varint(self.object_id())
+
+    def account(self):
+        return varint(self.object_id())
+
+    def pubkey(self):
+        return bytes([self.rng.choice((2, 3))]) + bytes(self.rng.getrandbits(8) for _ in range(32))
+
+    def memo(self):
+        length = self.shape['memo_len']
+        length = (length + 15) // 16 * 16           # Cipher text is whole AES blocks
+        return (self.pubkey() + self.pubkey() + struct.pack('<Q', self.rng.getrandbits(64))
+                + varint(length) + bytes(self.rng.getrandbits(8) for _ in range(length)))
+
+    def authority(self):
+        nauths = self.shape['auths']
+        accounts = sorted(set(self.object_id() for _ in range(nauths)))
+        out = struct.pack('<I', 1) + varint(len(accounts))
+        for acct in accounts:
+            out += varint(acct) + struct.pack('<H', 1)
+        out += varint(nauths)
+        for _ in range(nauths):
+            out += self.pubkey() + struct.pack('<H', 1)
+        return out + varint(0)                      # address_auths
+
+    def account_options(self):
+        nvotes = self.shape['votes']
+        votes = sorted(set((self.rng.randint(0, 1 << 24) << 8) | self.rng.randint(0, 3)
+                           for _ in range(nvotes)))
+        out = self.pubkey() + self.account() + struct.pack('<HH', 0, 0) + varint(len(votes))
+        for vote in votes:
+            out += struct.pack('<I', vote)
+        return out + varint(0)                      # extensions
+
+    def op_transfer(self):
+        out = self.asset() + self.account() + self.account() + self.asset()
+        if self.shape['memo_len'] > 0:
+            out += b'\x01' + self.memo()
+        else:
+            out += b'\x00'
+        return out + varint(0)
+
+    def op_limit_order_create(self):
+        return (self.asset() + self.account() + self.asset() + self.asset()
+                + struct.pack('<I', 1546300800) + b'\x00' + varint(0))
+
+    def op_limit_order_cancel(self):
+        return self.asset() + self.account() + varint(self.object_id()) + varint(0)
+
+    def op_call_order_update(self):
+        out = (self.asset() + self.account()
+               + struct.pack('<q', self.rng.randint(-10**12, 10**12)) + varint(self.object_id())
+               + struct.pack('<q', self.rng.randint(-10**12, 10**12)) + varint(self.object_id()))
+        if self.rng.getrandbits(1):
+            return out + varint(1) + varint(0) + struct.pack('<H', self.rng.randint(1001, 3000))
+        return out + varint(0)                      # No target_collateral_ratio
+
+    def op_account_update(self):
+        return (self.asset() + self.account()
+                + b'\x01' + self.authority()
+                + b'\x01' + self.authority()
+                + b'\x01' + self.account_options()
+                + varint(0))
+
+    def op_account_upgrade(self):
+        return self.asset() + self.account() + b'\x01' + varint(0)
+
+    def op_proposal_create(self):
+        # As TLV fields: those before proposed_ops, its size, each op's id and
+        # payload, then those after it.
+        names = [n for n in self.shape['mix'] if n != 'proposal_create'] or ['transfer']
+        fields = [self.asset() + self.account() + struct.pack('<I', 1546300800),
+                  varint(self.shape['proposed'])]
+        for i in range(self.shape['proposed']):
+            name = names[i % len(names)]
+            fields += [varint(OP_IDS[name]), getattr(self, 'op_' + name)()]
+        review = b'\x01' + struct.pack('<I', 3600) if self.rng.getrandbits(1) else b'\x00'
+        return fields + [review + varint(0)]
+
+    def op_bid_collateral(self):
+        return self.asset() + self.account() + self.asset() + self.asset() + varint(0)
+
+    def operations(self):
+        """List of (opId, payload fields) per op; most ops' payload is one field."""
+        mix = self.shape['mix']
+        ops = []
+        for name in (mix[i % len(mix)] for i in range(self.shape['ops'])):
+            fields = getattr(self, 'op_' + name)()
+            ops.append((OP_IDS[name], fields if isinstance(fields, list) else [fields]))
+        return ops
+
+def cached_length(opId, fields):
+    """Bytes the device caches for the op; proposed ops it caches only if there's room."""
+    if opId == OP_IDS['proposal_create']:
+        return len(fields[0]) + len(fields[1]) + len(fields[-1])
+    return sum(len(f) for f in fields)
+
+def encode(chain_id, operations, rng):
+    out = der_octet_string(chain_id)
+    out += der_octet_string(struct.pack('<H', rng.getrandbits(16)))     # ref_block_num
+    out += der_octet_string(struct.pack('<I', rng.getrandbits(32)))     # ref_block_prefix
+    out += der_octet_string(struct.pack('<I', 1546300800))              # expiration
+    out += der_octet_string(varint(len(operations)))
+    for opId, fields in operations:
+        out += der_octet_string(varint(opId))
+        for field in fields:
+            out += der_octet_string(field)
+    out += der_octet_string(varint(0))                                  # extensions
+    return out
+
+def int_list(text):
+    return [int(x) for x in text.split(',')]
+
+def mix_list(text):
+    mixes = []
+    for mix in text.split(','):
+        names = mix.split('+')
+        for name in names:
+            if name not in OP_IDS:
+                raise argparse.ArgumentTypeError("unknown op '%s'; choose from %s"
+                                                 % (name, ", ".join(OP_IDS)))
+        mixes.append(names)
+    return mixes
+
+parser = argparse.ArgumentParser(description="Generate synthetic TLV-encoded transactions.")
+parser.add_argument('--ops', type=int_list, default=[1], help="number of operations per tx")
+parser.add_argument('--mix', type=mix_list, default=[['transfer']],
+                    help="op mix, as '+'-joined op names cycled through, e.g. transfer+limit_order_create")
+parser.add_argument('--memo-len', type=int_list, default=[0], help="transfer memo length in bytes (0 = no memo)")
+parser.add_argument('--votes', type=int_list, default=[2], help="votes in account_update options")
+parser.add_argument('--auths', type=int_list, default=[1], help="account and key auths per authority")
+parser.add_argument('--proposed', type=int_list, default=[2], help="ops proposed per proposal_create")
+parser.add_argument('--id-bytes', type=int_list, default=[3], help="varint width of object ids (1..7)")
+parser.add_argument('--count', type=int, default=1, help="transactions per shape")
+parser.add_argument('--seed', type=int, default=0, help="random seed, for reproducible output")
+parser.add_argument('--chain_id', default=CHAIN_ID_MAINNET, help="chain ID to prepend")
+parser.add_argument('--jsonl', action='store_true',
+                    help="write JSON lines with shape and size, rather than bare hex lines")
+args = parser.parse_args()
+
+rng = random.Random(args.seed)
+chain_id = binascii.unhexlify(args.chain_id)
+
+for ops, mix, memo_len, votes, auths, proposed, id_bytes in itertools.product(
+        args.ops, args.mix, args.memo_len, args.votes, args.auths, args.proposed, args.id_bytes):
+    shape = {'ops': ops, 'mix': mix, 'memo_len': memo_len, 'votes': votes,
+             'auths': auths, 'proposed': proposed, 'id_bytes': id_bytes}
+    for _ in range(args.count):
+        operations = Generator(rng, shape).operations()
+        tlv = encode(chain_id, operations, rng)
+        if args.jsonl:
+            op_data = sum(cached_length(opId, fields) for opId, fields in operations)
+            print(json.dumps({
+                'shape': shape,
+                'tlv_bytes': len(tlv),
+                'op_data_bytes': op_data,
+                'exceeds_device_limits': (ops > DEVICE_MAX_OPERATIONS
+                                          or op_data > DEVICE_OP_DATA_BUFFER),
+                'tlv': binascii.hexlify(tlv).decode(),
+            }))
+        else:
+            print(binascii.hexlify(tlv).decode())
+    sys.stdout.flush()
@@ -17,8 +17,11 @@
 ********************************************************************************/
 """
 
+import os
 import struct
-from ledgerblue.comm import getDongle
+import sys
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), 'SimpleGUIWallet'))
+from nano_session import NanoSession
 import argparse
 import hashlib
 from base58 import b58encode
@@ -47,8 +50,8 @@ if args.path is None:
 donglePath = parse_bip32_path(args.path)
 apdu = binascii.unhexlify("B5020001" + "{:02x}".format(len(donglePath) + 1) + "{:02x}".format(int(len(donglePath) / 4))) + donglePath
 
-dongle = getDongle(True)
-result = dongle.exchange(apdu)
+session = NanoSession(True).open()
+result = session.exchange(apdu)
 offset = 1 + result[0]
 address = result[offset + 1: offset + 1 + result[offset]]
 
@@ -68,4 +71,4 @@ print ("Calculated from public key: Address BTS" + b58encode(bytes(buff)).decode
 print ("      Received from ledger: Address " + address.decode())
 
 apdu = binascii.unhexlify("B5020101" + "{:02x}".format(len(donglePath) + 1) + "{:02x}".format(int(len(donglePath) / 4))) + donglePath
-result = dongle.exchange(apdu)
+result = session.exchange(apdu)
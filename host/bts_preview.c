@@ -0,0 +1,182 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "os.h"
+#include "cx.h"
+#include "bts_preview.h"
+#include "bts_networks.h"
+#include "bts_stream.h"
+#include "bts_totals.h"
+#include "bts_parse_operations.h"
+#include "bts_op_registry.h"
+#include "bts_t_memo.h"
+#include "app_ui_displays.h"
+
+union ui_buffers_u ui_buffers;      // Allocated in app_ui_displays.c on device
+
+/**
+ * On device, app_memo.c.  The host holds no keys, so encrypted memos are
+ * previewed by length only.
+ */
+bool decryptBtsMemo(const bts_memo_type_t *memo, char *buffer, size_t bufferLength) {
+    return false;
+}
+
+static cx_sha256_t sha256;
+static cx_sha256_t txIdSha256;
+static uint8_t messageHash[32];
+static bool finished = false;
+static bool faulted = true;         // No stream begun yet
+
+void btsPreviewBegin(void) {
+    finished = false;
+    faulted = false;
+    cx_sha256_init(&sha256);
+    cx_sha256_init(&txIdSha256);
+    initTxProcessingContext(&sha256, &txIdSha256);
+    initTxProcessingContent();
+}
+
+int btsPreviewFeed(const uint8_t *chunk, uint32_t length) {
+    parserStatus_e result;
+
+    if (finished || faulted || !checkInitTxProcessingContext()) {
+        return STREAM_FAULT;
+    }
+    result = processTxStream(chunk, length);
+    if (result == STREAM_FINISHED) {
+        // As in handleSign() once the last APDU is ingested:
+        cx_hash(&sha256.header, CX_LAST, messageHash, 0, messageHash);
+        cx_hash(&txIdSha256.header, CX_LAST, txContent.txIdHash, 0, txContent.txIdHash);
+        finished = true;
+    } else if (result != STREAM_PROCESSING) {
+        // The rest of a faulted stream is garbage to the device too.
+        faulted = true;
+        result = STREAM_FAULT;
+    }
+    return result;
+}
+
+int btsPreviewParse(const uint8_t *tlv, uint32_t length) {
+    btsPreviewBegin();
+    return btsPreviewFeed(tlv, length);
+}
+
+void btsPreviewDigests(uint8_t msgHash[32], uint8_t txId[32]) {
+    os_memmove(msgHash, messageHash, sizeof(messageHash));
+    os_memmove(txId, txContent.txIdHash, sizeof(txContent.txIdHash));
+}
+
+uint32_t btsPreviewOperationCount(void) {
+    return finished ? txContent.operationCount : 0;
+}
+
+int btsPreviewOperationSupported(uint32_t opIdx) {
+    if (!finished || opIdx >= txContent.operationCount) {
+        return 0;
+    }
+    return getOperationInfo(txContent.operationIds[opIdx])->deserializer != NULL;
+}
+
+static void emitScreen(btsPreviewScreen_t *screens, uint32_t maxScreens, uint32_t *count,
+                       const char *label, const char *value) {
+    if (*count < maxScreens) {
+        btsPreviewScreen_t *screen = &screens[*count];
+        snprintf(screen->label, sizeof(screen->label), "%s", label);
+        snprintf(screen->value, sizeof(screen->value), "%s", value);
+    }
+    (*count)++;
+}
+
+static void clearUiBuffers() {
+    os_memset(&ui_buffers, 0, sizeof(ui_buffers));
+}
+
+/**
+ * Walks the review screens into `screens`, as btsPreviewRender().  Kept out of
+ * the TRY frame in btsPreviewRender() so its counter can't be clobbered by the
+ * longjmp of a THROW.
+ */
+static uint32_t renderScreens(btsPreviewScreen_t *screens, uint32_t maxScreens) {
+    uint32_t n = 0;
+
+    // Steps 0 to 3 of ui_approval_nanos.  Totals has subscreens, like
+    // an argument (see below):
+    emitScreen(screens, maxScreens, &n, "Confirm", "Transaction");
+    txContent.subargRemainP1 = 0;
+    do {
+        clearUiBuffers();
+        printTxTotals();
+        emitScreen(screens, maxScreens, &n,
+                   ui_buffers.sign_tx.paramLabel, ui_buffers.sign_tx.paramValue);
+        if (txContent.subargRemainP1 > 0) {
+            txContent.subargRemainP1--;
+        }
+    } while (txContent.subargRemainP1 > 0);
+    clearUiBuffers();
+    printTxId(ui_buffers.sign_tx.paramValue, sizeof(ui_buffers.sign_tx.paramValue));
+    emitScreen(screens, maxScreens, &n, "Tx ID", ui_buffers.sign_tx.paramValue);
+    clearUiBuffers();
+    printNetwork(ui_buffers.sign_tx.paramValue, sizeof(ui_buffers.sign_tx.paramValue));
+    emitScreen(screens, maxScreens, &n, "Network", ui_buffers.sign_tx.paramValue);
+
+    // Step 4 and on, per operation.  An argument with subarguments holds
+    // its step while subargRemainP1 counts down, as the ticker does.
+    for (uint32_t op = 0; op < txContent.operationCount; op++) {
+        txContent.currentOperation = op;
+        clearUiBuffers();
+        updateOperationContent();
+        emitScreen(screens, maxScreens, &n,
+                   ui_buffers.sign_tx.paramLabel, ui_buffers.sign_tx.paramValue);
+        for (uint8_t arg = 0; arg < txContent.argumentCount; arg++) {
+            txContent.subargRemainP1 = 0;
+            do {
+                clearUiBuffers();
+                printTxOpArgument(arg);
+                emitScreen(screens, maxScreens, &n,
+                           ui_buffers.sign_tx.paramLabel, ui_buffers.sign_tx.paramValue);
+                if (txContent.subargRemainP1 > 0) {
+                    txContent.subargRemainP1--;
+                }
+            } while (txContent.subargRemainP1 > 0);
+        }
+    }
+    return n;
+}
+
+uint32_t btsPreviewRender(btsPreviewScreen_t *screens, uint32_t maxScreens) {
+    volatile uint32_t count = 0;
+
+    if (!finished) {
+        return 0;
+    }
+
+    BEGIN_TRY {
+        TRY {
+            count = renderScreens(screens, maxScreens);
+        }
+        CATCH_ALL {
+            count = 0;
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+
+    return count;
+}
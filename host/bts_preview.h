@@ -0,0 +1,69 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * Host-side preview of the Sign Transaction workflow.  Runs the device's own
+ * stream parser and argument printers (src/bts_*.c) over a TLV-encoded
+ * transaction and returns the label/value screens the Nano would display, in
+ * order.  Exported from libbtspreview.so for the Python bindings in
+ * SimpleGUIWallet/device_preview.py.
+ *
+ * Not thread safe: like the device, the parser keeps its state in globals.
+ */
+
+#ifndef __BTS_PREVIEW_H__
+#define __BTS_PREVIEW_H__
+
+#include <stdint.h>
+
+#define BTS_PREVIEW_API __attribute__((visibility("default")))
+
+#define BTS_PREVIEW_LABEL_SIZE 48   // Matches ui_buffers.sign_tx.paramLabel
+#define BTS_PREVIEW_VALUE_SIZE 128  // Matches ui_buffers.sign_tx.paramValue
+
+typedef struct btsPreviewScreen_t {
+    char label[BTS_PREVIEW_LABEL_SIZE];
+    char value[BTS_PREVIEW_VALUE_SIZE];
+} btsPreviewScreen_t;
+
+/* Ingests a whole TLV stream as INS_SIGN would.  Returns a parserStatus_e:
+ * STREAM_FINISHED on success, STREAM_PROCESSING if the stream is truncated, or
+ * STREAM_FAULT if the device would reject it. */
+BTS_PREVIEW_API int btsPreviewParse(const uint8_t *tlv, uint32_t length);
+
+/* The same, one APDU's worth at a time: btsPreviewBegin() resets the parser as
+ * the first INS_SIGN APDU does, then each btsPreviewFeed() ingests one APDU's
+ * transaction bytes and returns a parserStatus_e as above.  Feeding without a
+ * Begin, or after STREAM_FINISHED or STREAM_FAULT, returns STREAM_FAULT. */
+BTS_PREVIEW_API void btsPreviewBegin(void);
+BTS_PREVIEW_API int btsPreviewFeed(const uint8_t *chunk, uint32_t length);
+
+/* After STREAM_FINISHED: the message digest the device signs, and the TxID. */
+BTS_PREVIEW_API void btsPreviewDigests(uint8_t msgHash[32], uint8_t txId[32]);
+
+/* After STREAM_FINISHED: number of operations, and whether operation opIdx is
+ * one the app can display in full (i.e. not shown as "Unsupported"). */
+BTS_PREVIEW_API uint32_t btsPreviewOperationCount(void);
+BTS_PREVIEW_API int btsPreviewOperationSupported(uint32_t opIdx);
+
+/* After STREAM_FINISHED: writes up to maxScreens screens and returns the total
+ * number the device would show, which may exceed maxScreens.  Returns 0 if a
+ * printer threw, which on device would reset the app. */
+BTS_PREVIEW_API uint32_t btsPreviewRender(btsPreviewScreen_t *screens, uint32_t maxScreens);
+
+#endif
@@ -0,0 +1,69 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "os.h"
+#include "cx.h"
+#include "bts_sim.h"
+#include "bts_types.h"
+#include "eos_utils.h"
+
+// As in app_ux_sign_tx.c:
+static const uint8_t SECP256K1_N[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+                                      0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b,
+                                      0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41};
+
+uint32_t btsSimPublicKeyToAddress(const uint8_t W[65], char *out, uint32_t outLength) {
+    volatile uint32_t length = 0;    // public_key_to_wif() counts the NUL
+    uint8_t key[65];
+
+    os_memmove(key, W, sizeof(key));
+    BEGIN_TRY {
+        TRY {
+            length = public_key_to_wif(key, sizeof(key), out, outLength);
+        }
+        CATCH_ALL {
+            length = 0;
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+    return length;
+}
+
+void btsSimNonce(uint8_t nonce[32], const uint8_t hash[32], const uint8_t *privateKey,
+                 uint8_t V[33], uint8_t K[32]) {
+    uint8_t h1[32];
+    uint8_t x[32];
+
+    os_memmove(h1, hash, sizeof(h1));
+    if (privateKey != NULL) {
+        os_memmove(x, privateKey, sizeof(x));
+    }
+    rng_rfc6979(nonce, h1, privateKey != NULL ? x : NULL, privateKey != NULL ? sizeof(x) : 0,
+                SECP256K1_N, sizeof(SECP256K1_N), V, K);
+    os_memset(x, 0, sizeof(x));
+}
+
+int btsSimIsCanonical(const uint8_t rs[64]) {
+    uint8_t sig[64];
+
+    os_memmove(sig, rs, sizeof(sig));
+    return check_canonical(sig);
+}
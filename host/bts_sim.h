@@ -0,0 +1,45 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * The app's key-handling helpers, exported from libbtspreview.so for the device
+ * simulator (host/nano_simulator.py), so that it formats addresses and picks
+ * signing nonces exactly as the Nano does.  The elliptic-curve arithmetic
+ * itself, done by BOLOS on device, is left to the simulator.
+ */
+
+#ifndef __BTS_SIM_H__
+#define __BTS_SIM_H__
+
+#include <stdint.h>
+#include "bts_preview.h"
+
+/* The BTS... address for uncompressed public key W, as public_key_to_wif()
+ * renders it for INS_GET_PUBLIC_KEY, NUL-terminated.  Returns 0 on error. */
+BTS_PREVIEW_API uint32_t btsSimPublicKeyToAddress(const uint8_t W[65], char *out, uint32_t outLength);
+
+/* The next RFC 6979 nonce candidate for signing hash with privateKey, as in
+ * io_seproxyhal_touch_tx_ok().  Pass privateKey for the first candidate and
+ * NULL for each retry; V and K carry the generator state between calls. */
+BTS_PREVIEW_API void btsSimNonce(uint8_t nonce[32], const uint8_t hash[32], const uint8_t *privateKey,
+                                 uint8_t V[33], uint8_t K[32]);
+
+/* Nonzero if the 64-byte r || s is canonical as the device requires. */
+BTS_PREVIEW_API int btsSimIsCanonical(const uint8_t rs[64]);
+
+#endif
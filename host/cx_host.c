@@ -0,0 +1,267 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * Portable implementations of the BOLOS cx_* hash calls used by the parser,
+ * for the host preview build.  Plain reference implementations; speed is not a
+ * concern at transaction sizes.
+ */
+
+#include "os.h"
+#include "cx.h"
+
+jmp_buf *host_try_context = NULL;
+exception_t host_exception = 0;
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+/*
+ * SHA-256
+ */
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static void sha256_block(uint32_t *acc, const uint8_t *block) {
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h;
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[4*i] << 24) | ((uint32_t)block[4*i+1] << 16)
+             | ((uint32_t)block[4*i+2] << 8) | block[4*i+3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR32(w[i-15], 7) ^ ROTR32(w[i-15], 18) ^ (w[i-15] >> 3);
+        uint32_t s1 = ROTR32(w[i-2], 17) ^ ROTR32(w[i-2], 19) ^ (w[i-2] >> 10);
+        w[i] = w[i-16] + s0 + w[i-7] + s1;
+    }
+    a = acc[0]; b = acc[1]; c = acc[2]; d = acc[3];
+    e = acc[4]; f = acc[5]; g = acc[6]; h = acc[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25))
+                    + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        uint32_t t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22))
+                    + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    acc[0] += a; acc[1] += b; acc[2] += c; acc[3] += d;
+    acc[4] += e; acc[5] += f; acc[6] += g; acc[7] += h;
+}
+
+int cx_sha256_init(cx_sha256_t *hash) {
+    static const uint32_t iv[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    os_memset(hash, 0, sizeof(*hash));
+    hash->header.algo = CX_SHA256;
+    os_memmove(hash->acc, iv, sizeof(iv));
+    return CX_SHA256;
+}
+
+/*
+ * RIPEMD-160
+ */
+
+static const uint8_t rmd_r[80] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+    3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+    1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+    4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+};
+static const uint8_t rmd_rp[80] = {
+    5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+    6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+    15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+    8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+    12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+};
+static const uint8_t rmd_s[80] = {
+    11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+    7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+    11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+    11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+    9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+};
+static const uint8_t rmd_sp[80] = {
+    8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+    9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+    9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+    15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+    8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+};
+static const uint32_t rmd_k[5]  = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+static const uint32_t rmd_kp[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+
+static uint32_t rmd_f(int j, uint32_t x, uint32_t y, uint32_t z) {
+    switch (j / 16) {
+    case 0: return x ^ y ^ z;
+    case 1: return (x & y) | (~x & z);
+    case 2: return (x | ~y) ^ z;
+    case 3: return (x & z) | (y & ~z);
+    default: return x ^ (y | ~z);
+    }
+}
+
+static void ripemd160_block(uint32_t *acc, const uint8_t *block) {
+    uint32_t x[16];
+    for (int i = 0; i < 16; i++) {
+        x[i] = block[4*i] | ((uint32_t)block[4*i+1] << 8)
+             | ((uint32_t)block[4*i+2] << 16) | ((uint32_t)block[4*i+3] << 24);
+    }
+    uint32_t al = acc[0], bl = acc[1], cl = acc[2], dl = acc[3], el = acc[4];
+    uint32_t ar = al, br = bl, cr = cl, dr = dl, er = el;
+    for (int j = 0; j < 80; j++) {
+        uint32_t t = ROTL32(al + rmd_f(j, bl, cl, dl) + x[rmd_r[j]] + rmd_k[j / 16], rmd_s[j]) + el;
+        al = el; el = dl; dl = ROTL32(cl, 10); cl = bl; bl = t;
+        t = ROTL32(ar + rmd_f(79 - j, br, cr, dr) + x[rmd_rp[j]] + rmd_kp[j / 16], rmd_sp[j]) + er;
+        ar = er; er = dr; dr = ROTL32(cr, 10); cr = br; br = t;
+    }
+    uint32_t t = acc[1] + cl + dr;
+    acc[1] = acc[2] + dl + er;
+    acc[2] = acc[3] + el + ar;
+    acc[3] = acc[4] + al + br;
+    acc[4] = acc[0] + bl + cr;
+    acc[0] = t;
+}
+
+int cx_ripemd160_init(cx_ripemd160_t *hash) {
+    static const uint32_t iv[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+    os_memset(hash, 0, sizeof(*hash));
+    hash->header.algo = CX_RIPEMD160;
+    os_memmove(hash->acc, iv, sizeof(iv));
+    return CX_RIPEMD160;
+}
+
+/*
+ * Common Merkle–Damgård driver.  SHA-256 is big-endian, RIPEMD-160 little-endian.
+ */
+
+static void hash_block(cx_hash_t *hash, const uint8_t *block) {
+    if (hash->algo == CX_SHA256) {
+        sha256_block(((cx_sha256_t *)hash)->acc, block);
+    } else {
+        ripemd160_block(((cx_ripemd160_t *)hash)->acc, block);
+    }
+}
+
+int cx_hash(cx_hash_t *hash, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *out) {
+    hash->counter += len;
+    while (len > 0) {
+        uint32_t n = MIN(len, sizeof(hash->block) - hash->blen);
+        os_memmove(hash->block + hash->blen, in, n);
+        hash->blen += n;
+        in += n;
+        len -= n;
+        if (hash->blen == sizeof(hash->block)) {
+            hash_block(hash, hash->block);
+            hash->blen = 0;
+        }
+    }
+    if (!(mode & CX_LAST)) {
+        return 0;
+    }
+
+    uint64_t bits = hash->counter * 8;
+    bool bigEndian = (hash->algo == CX_SHA256);
+    hash->block[hash->blen++] = 0x80;
+    if (hash->blen > 56) {
+        os_memset(hash->block + hash->blen, 0, sizeof(hash->block) - hash->blen);
+        hash_block(hash, hash->block);
+        hash->blen = 0;
+    }
+    os_memset(hash->block + hash->blen, 0, 56 - hash->blen);
+    for (int i = 0; i < 8; i++) {
+        hash->block[bigEndian ? 63 - i : 56 + i] = (uint8_t)(bits >> (8 * i));
+    }
+    hash_block(hash, hash->block);
+
+    if (bigEndian) {
+        uint32_t *acc = ((cx_sha256_t *)hash)->acc;
+        for (int i = 0; i < 8; i++) {
+            out[4*i]   = acc[i] >> 24;
+            out[4*i+1] = acc[i] >> 16;
+            out[4*i+2] = acc[i] >> 8;
+            out[4*i+3] = acc[i];
+        }
+        return 32;
+    } else {
+        uint32_t *acc = ((cx_ripemd160_t *)hash)->acc;
+        for (int i = 0; i < 5; i++) {
+            out[4*i]   = acc[i];
+            out[4*i+1] = acc[i] >> 8;
+            out[4*i+2] = acc[i] >> 16;
+            out[4*i+3] = acc[i] >> 24;
+        }
+        return 20;
+    }
+}
+
+/*
+ * HMAC-SHA256
+ */
+
+int cx_hmac_sha256_init(cx_hmac_sha256_t *hmac, const unsigned char *key, unsigned int key_len) {
+    uint8_t pad[64];
+    if (key_len > sizeof(hmac->key)) {
+        cx_sha256_init(&hmac->inner);
+        cx_hash(&hmac->inner.header, CX_LAST, key, key_len, pad);
+        key = pad;
+        key_len = 32;
+    }
+    os_memmove(pad, key, key_len);  // key may alias hmac->key
+    os_memset(hmac->key, 0, sizeof(hmac->key));
+    os_memmove(hmac->key, pad, key_len);
+    for (int i = 0; i < 64; i++) {
+        pad[i] = hmac->key[i] ^ 0x36;
+    }
+    cx_sha256_init(&hmac->inner);
+    cx_hash(&hmac->inner.header, 0, pad, sizeof(pad), NULL);
+    return CX_SHA256;
+}
+
+int cx_hmac(cx_hmac_t *hmac, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *mac) {
+    uint8_t pad[64];
+    uint8_t inner[32];
+    if (!(mode & CX_LAST)) {
+        return cx_hash(&hmac->inner.header, 0, in, len, NULL);
+    }
+    cx_hash(&hmac->inner.header, CX_LAST, in, len, inner);
+    for (int i = 0; i < 64; i++) {
+        pad[i] = hmac->key[i] ^ 0x5c;
+    }
+    cx_sha256_init(&hmac->inner);
+    cx_hash(&hmac->inner.header, 0, pad, sizeof(pad), NULL);
+    cx_hash(&hmac->inner.header, CX_LAST, inner, sizeof(inner), mac);
+
+    // Rearm for reuse with the same key, as on device.
+    cx_hmac_sha256_init(hmac, hmac->key, sizeof(hmac->key));
+    return 32;
+}
@@ -0,0 +1,209 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * Stand-alone driver for fuzz_stream.c, for hosts without libFuzzer.  Runs every
+ * input given (files, or the files in a directory) once and reports the slowest,
+ * then runs -runs=N random mutations of them.  Not coverage guided, so it is no
+ * substitute for libFuzzer, but it builds with any C compiler and sanitizers.
+ * An input that crashes is written to crash-standalone.
+ *
+ *   make -C host fuzz-standalone
+ *   host/fuzz_stream_standalone -runs=100000 host/fuzz_corpus
+ */
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/* Set by AddressSanitizer, if linked. */
+extern void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
+
+#define MAX_INPUTS 1024
+#define MAX_INPUT_SIZE 8192
+
+typedef struct input_t {
+    char name[256];
+    uint8_t *data;
+    size_t size;
+} input_t;
+
+static input_t inputs[MAX_INPUTS];
+static size_t inputCount = 0;
+
+static uint8_t current[MAX_INPUT_SIZE];
+static size_t currentSize = 0;
+
+static void saveCurrent(void) {
+    FILE *f = fopen("crash-standalone", "wb");
+    if (f != NULL) {
+        fwrite(current, 1, currentSize, f);
+        fclose(f);
+        fprintf(stderr, "Crashing input written to crash-standalone\n");
+    }
+}
+
+static void onSignal(int sig) {
+    saveCurrent();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void loadFile(const char *path) {
+    FILE *f = fopen(path, "rb");
+    input_t *input = &inputs[inputCount];
+
+    if (f == NULL || inputCount == MAX_INPUTS) {
+        fprintf(stderr, "Skipping %s\n", path);
+        if (f != NULL) {
+            fclose(f);
+        }
+        return;
+    }
+    input->data = malloc(MAX_INPUT_SIZE);
+    input->size = fread(input->data, 1, MAX_INPUT_SIZE, f);
+    snprintf(input->name, sizeof(input->name), "%s", path);
+    fclose(f);
+    inputCount++;
+}
+
+static void loadPath(const char *path) {
+    DIR *dir = opendir(path);
+    struct dirent *entry;
+    char file[512];
+
+    if (dir == NULL) {
+        loadFile(path);
+        return;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+            loadFile(file);
+        }
+    }
+    closedir(dir);
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double runCurrent(void) {
+    const double start = now();
+    LLVMFuzzerTestOneInput(current, currentSize);
+    return now() - start;
+}
+
+/* One to four random edits: overwrite, flip, insert, or delete a byte, or truncate. */
+static void mutateCurrent(void) {
+    int edits = 1 + rand() % 4;
+
+    while (edits-- > 0) {
+        const size_t pos = (currentSize == 0) ? 0 : (size_t)rand() % currentSize;
+        switch (rand() % 5) {
+        case 0:
+            if (currentSize > 0) current[pos] = (uint8_t)rand();
+            break;
+        case 1:
+            if (currentSize > 0) current[pos] ^= (uint8_t)(1 << (rand() % 8));
+            break;
+        case 2:
+            if (currentSize < MAX_INPUT_SIZE) {
+                memmove(current + pos + 1, current + pos, currentSize - pos);
+                current[pos] = (uint8_t)rand();
+                currentSize++;
+            }
+            break;
+        case 3:
+            if (currentSize > 0) {
+                memmove(current + pos, current + pos + 1, currentSize - pos - 1);
+                currentSize--;
+            }
+            break;
+        default:
+            currentSize = pos;
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned long runs = 0;
+    unsigned int seed = 1;
+    double slowest = 0, total = 0;
+    const char *slowestName = "";
+    size_t i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        if (strncmp(argv[arg], "-runs=", 6) == 0) {
+            runs = strtoul(argv[arg] + 6, NULL, 10);
+        } else if (strncmp(argv[arg], "-seed=", 6) == 0) {
+            seed = (unsigned int)strtoul(argv[arg] + 6, NULL, 10);
+        } else {
+            loadPath(argv[arg]);
+        }
+    }
+    if (inputCount == 0) {
+        fprintf(stderr, "usage: %s [-runs=N] [-seed=S] corpus_dir_or_file...\n", argv[0]);
+        return 1;
+    }
+    srand(seed);
+    signal(SIGABRT, onSignal);
+    signal(SIGSEGV, onSignal);
+    if (__sanitizer_set_death_callback != NULL) {
+        __sanitizer_set_death_callback(saveCurrent);
+    }
+
+    for (i = 0; i < inputCount; i++) {
+        double elapsed;
+        memcpy(current, inputs[i].data, inputs[i].size);
+        currentSize = inputs[i].size;
+        elapsed = runCurrent();
+        total += elapsed;
+        if (elapsed > slowest) {
+            slowest = elapsed;
+            slowestName = inputs[i].name;
+        }
+    }
+    printf("Ran %zu inputs in %.3f ms; slowest %s (%.3f ms)\n",
+           inputCount, total * 1e3, slowestName, slowest * 1e3);
+
+    if (runs > 0) {
+        unsigned long run;
+        total = 0;
+        for (run = 0; run < runs; run++) {
+            const input_t *input = &inputs[(size_t)rand() % inputCount];
+            memcpy(current, input->data, input->size);
+            currentSize = input->size;
+            mutateCurrent();
+            total += runCurrent();
+        }
+        printf("Ran %lu mutations in %.2f s: %.0f exec/s\n", runs, total, runs / total);
+    }
+    return 0;
+}
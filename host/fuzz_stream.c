@@ -0,0 +1,72 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * libFuzzer target for the Sign Transaction stream parser.  Each input is a
+ * chunking plan followed by a TLV stream as INS_SIGN would receive it; the stream
+ * is fed through the host preview (bts_preview.c) in chunks the plan sizes, so the
+ * fuzzer explores where fields split across APDUs apart from what they hold:
+ *
+ *   [n][length 1]..[length n][TLV stream]
+ *
+ * n is the first byte modulo FUZZ_MAX_PLAN.  Chunks take the lengths in turn,
+ * cycling, each length byte b giving 1 + b % FUZZ_MAX_CHUNK bytes; with n = 0,
+ * every chunk is FUZZ_MAX_CHUNK bytes.  A stream that parses is then rendered, and must render:
+ * a printer that throws on an accepted transaction resets the app on device.
+ *
+ *   make -C host fuzz && host/fuzz_stream host/fuzz_corpus
+ *
+ * Without libFuzzer, fuzz_main.c drives the same target (make fuzz-standalone).
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "bts_preview.h"
+#include "bts_stream.h"
+
+#define FUZZ_MAX_CHUNK 255  // Most tx bytes one INS_SIGN APDU can carry
+#define FUZZ_MAX_PLAN 8     // Chunk lengths in a plan, at most
+#define FUZZ_MAX_SCREENS 64
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static btsPreviewScreen_t screens[FUZZ_MAX_SCREENS];
+    const uint8_t *plan = data + 1;
+    size_t planLength, pos, chunkIdx = 0;
+    int status = STREAM_PROCESSING;
+
+    if (size == 0 || size < 1 + (size_t)(data[0] % FUZZ_MAX_PLAN)) {
+        return 0;
+    }
+    planLength = data[0] % FUZZ_MAX_PLAN;
+    pos = 1 + planLength;
+
+    btsPreviewBegin();
+    while (pos < size && status == STREAM_PROCESSING) {
+        const uint32_t chunk = (planLength == 0)
+            ? FUZZ_MAX_CHUNK : 1 + plan[chunkIdx++ % planLength] % FUZZ_MAX_CHUNK;
+        const uint32_t length = (size - pos < chunk) ? size - pos : chunk;
+        status = btsPreviewFeed(data + pos, length);
+        pos += length;
+    }
+
+    if (status == STREAM_FINISHED
+        && btsPreviewRender(screens, FUZZ_MAX_SCREENS) == 0) {
+        abort();
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * Host stand-in for the BOLOS SDK "cx.h".  Implements (in cx_host.c) the hashes
+ * the parser needs: SHA-256 for TxID and message digest, RIPEMD-160 for public
+ * key checksums, and HMAC-SHA256 so that eos_utils.c links.
+ */
+
+#ifndef __HOST_CX_H__
+#define __HOST_CX_H__
+
+#include <stdint.h>
+
+#define CX_LAST 1
+
+typedef enum {
+    CX_SHA256 = 3,
+    CX_RIPEMD160 = 1,
+} cx_md_t;
+
+typedef struct cx_hash_header_s {
+    cx_md_t  algo;
+    uint64_t counter;                   // Total bytes hashed so far
+    uint32_t blen;                      // Bytes pending in block[]
+    uint8_t  block[64];
+} cx_hash_t;
+
+typedef struct cx_sha256_s {
+    cx_hash_t header;
+    uint32_t  acc[8];
+} cx_sha256_t;
+
+typedef struct cx_ripemd160_s {
+    cx_hash_t header;
+    uint32_t  acc[5];
+} cx_ripemd160_t;
+
+typedef struct cx_hmac_sha256_s {
+    cx_sha256_t inner;
+    uint8_t     key[64];
+} cx_hmac_sha256_t;
+typedef cx_hmac_sha256_t cx_hmac_t;
+
+int cx_sha256_init(cx_sha256_t *hash);
+int cx_ripemd160_init(cx_ripemd160_t *hash);
+int cx_hash(cx_hash_t *hash, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *out);
+
+int cx_hmac_sha256_init(cx_hmac_sha256_t *hmac, const unsigned char *key, unsigned int key_len);
+int cx_hmac(cx_hmac_t *hmac, int mode, const unsigned char *in, unsigned int len,
+            unsigned char *mac);
+
+#endif
@@ -0,0 +1,78 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * Host stand-in for the BOLOS SDK "os.h", providing just what the transaction
+ * parser and printers in src/bts_*.c need.  Used only by the host preview build
+ * (see host/Makefile); never by the device build.
+ */
+
+#ifndef __HOST_OS_H__
+#define __HOST_OS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+typedef unsigned short exception_t;
+
+/* Exceptions: setjmp-based, with the same BEGIN_TRY / TRY / CATCH_OTHER /
+ * CATCH_ALL / FINALLY / END_TRY shape as the SDK.  An uncaught THROW aborts. */
+extern jmp_buf *host_try_context;
+extern exception_t host_exception;
+
+#define THROW(x) do {                                   \
+        host_exception = (x);                           \
+        if (host_try_context == NULL) abort();          \
+        longjmp(*host_try_context, 1);                  \
+    } while (0)
+
+#define BEGIN_TRY       { jmp_buf __jb; jmp_buf *__outer = host_try_context; int __st; \
+                          host_try_context = &__jb; __st = setjmp(__jb);
+#define TRY             if (__st == 0)
+#define CATCH_OTHER(e)  else for (exception_t e = host_exception, __once = \
+                              ((host_try_context = __outer), 1); __once; __once = 0)
+#define CATCH_ALL       else for (int __once = ((host_try_context = __outer), 1); \
+                              __once; __once = 0)
+#define FINALLY         if (1)
+#define END_TRY         host_try_context = __outer; }
+
+#define EXCEPTION               1
+#define INVALID_PARAMETER       2
+#define EXCEPTION_OVERFLOW      3
+
+#define PIC(x)      (x)
+#define os_memmove  memmove
+#define os_memset   memset
+#define os_memcmp   memcmp
+#define PRINTF(...)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#include "cx.h"      // The SDK os.h pulls in cx.h too
+
+#endif
@@ -0,0 +1,398 @@
+#!/usr/bin/env python3
+"""
+/*******************************************************************************
+*  Copyright of the Contributing Authors; see CONTRIBUTORS.md.
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+##
+## Stands in for a BitShares API node, for running the host tools offline and
+## in CI.  Serves JSON-RPC over HTTP, which python-bitshares accepts in place of
+## a wss:// node:
+##
+##     signTransaction.py --node http://127.0.0.1:8090 --tapos --broadcast
+##
+## Chain parameters, accounts, assets, balances and history come from a fixture
+## file (host/fixtures/mock_chain.json by default).  The head block advances in
+## real time from the fixture's head_block_number, so TaPoS is always fresh, and
+## broadcasts are checked for TaPoS and expiration the way a node checks them,
+## then recorded.  GET /broadcasts returns the recorded transactions.  If
+## bitsharesbase is installed, each broadcast's signatures are also recovered
+## and the signing keys recorded with it.
+##
+## A fixture's "responses" map gives canned results for any other method, by
+## name.
+##
+
+import argparse
+import calendar
+import hashlib
+import json
+import os
+import struct
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, HTTPServer
+from socketserver import ThreadingMixIn
+
+DEFAULT_FIXTURE = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'fixtures', 'mock_chain.json')
+MAX_EXPIRATION = 24 * 3600      # GRAPHENE_DEFAULT_MAX_TIME_UNTIL_EXPIRATION
+
+
+class RpcError(Exception):
+    pass
+
+
+def isoTime(seconds):
+    return time.strftime("%Y-%m-%dT%H:%M:%S", time.gmtime(seconds))
+
+
+def parseIsoTime(text):
+    return calendar.timegm(time.strptime(text, "%Y-%m-%dT%H:%M:%S"))
+
+
+class MockChain:
+
+    def __init__(self, fixture):
+        self.fixture = fixture
+        self.chain_id = fixture['chain_id']
+        self.prefix = fixture.get('address_prefix', 'BTS')
+        self.core = fixture.get('core_asset', '1.3.0')
+        self.interval = fixture.get('block_interval', 3)
+        self.baseBlock = fixture.get('head_block_number', 1000000)
+        self.startTime = int(time.time())
+        self.accounts = {a['id']: self._account(a) for a in fixture.get('accounts', [])}
+        self.accountsByName = {a['name']: a for a in self.accounts.values()}
+        self.assets = {a['id']: self._asset(a) for a in fixture.get('assets', [])}
+        self.assetsBySymbol = {a['symbol']: a for a in self.assets.values()}
+        self.lock = threading.Lock()
+        self.broadcasts = []
+        self.recordFile = None
+
+    ## Fixture objects, filled out with the fields a node returns.
+
+    def _account(self, a):
+        number = int(a['id'].split('.')[2])
+        authority = {"weight_threshold": 1, "account_auths": [], "key_auths": [], "address_auths": []}
+        full = {
+            "membership_expiration_date": "1970-01-01T00:00:00",
+            "registrar": "1.2.0", "referrer": "1.2.0", "lifetime_referrer": "1.2.0",
+            "network_fee_percentage": 2000, "lifetime_referrer_fee_percentage": 3000,
+            "referrer_rewards_percentage": 0,
+            "owner": authority, "active": authority,
+            "options": {"memo_key": self.prefix + "1111111111111111111111111111111114T1Anm",
+                        "voting_account": "1.2.5", "num_witness": 0, "num_committee": 0,
+                        "votes": [], "extensions": []},
+            "statistics": "2.6.%d" % number,
+            "whitelisting_accounts": [], "blacklisting_accounts": [],
+            "whitelisted_accounts": [], "blacklisted_accounts": [],
+            "owner_special_authority": [0, {}], "active_special_authority": [0, {}],
+            "top_n_control_flags": 0,
+        }
+        full.update(a)
+        return full
+
+    def _asset(self, a):
+        number = int(a['id'].split('.')[2])
+        full = {
+            "issuer": "1.2.0",
+            "options": {"max_supply": "1000000000000000", "market_fee_percent": 0,
+                        "max_market_fee": "1000000000000000", "issuer_permissions": 0, "flags": 0,
+                        "core_exchange_rate": {"base": {"amount": 1, "asset_id": "1.3.0"},
+                                               "quote": {"amount": 1, "asset_id": a['id']}},
+                        "whitelist_authorities": [], "blacklist_authorities": [],
+                        "whitelist_markets": [], "blacklist_markets": [],
+                        "description": "", "extensions": []},
+            "dynamic_asset_data_id": "2.3.%d" % number,
+        }
+        full.update(a)
+        return full
+
+    ## Blocks.  Ids carry the block number in their first four bytes, as on
+    ## chain, and are otherwise derived from it so they are stable across runs.
+
+    def headBlock(self):
+        return self.baseBlock + (int(time.time()) - self.startTime) // self.interval
+
+    def blockTime(self, block_num):
+        return self.startTime + (block_num - self.baseBlock) * self.interval
+
+    def blockId(self, block_num):
+        tail = hashlib.sha256(("%s:%d" % (self.chain_id, block_num)).encode()).digest()[:16]
+        return (struct.pack(">I", block_num) + tail).hex()
+
+    def blockHeader(self, block_num):
+        if block_num < 1 or block_num > self.headBlock():
+            return None
+        return {"previous": self.blockId(block_num - 1), "timestamp": isoTime(self.blockTime(block_num)),
+                "witness": "1.6.1", "transaction_merkle_root": "00" * 20, "extensions": []}
+
+    def dynamicGlobalProperties(self):
+        head = self.headBlock()
+        return {"id": "2.1.0", "head_block_number": head, "head_block_id": self.blockId(head),
+                "time": isoTime(self.blockTime(head)), "current_witness": "1.6.1",
+                "next_maintenance_time": isoTime(self.blockTime(head) + 3600),
+                "last_budget_time": isoTime(self.blockTime(head) - 3600),
+                "witness_budget": 0, "accounts_registered_this_interval": 0,
+                "recently_missed_count": 0, "current_aslot": head,
+                "recent_slots_filled": "340282366920938463463374607431768211455",
+                "dynamic_flags": 0, "last_irreversible_block_num": max(head - 15, 1)}
+
+    def globalProperties(self):
+        return {"id": "2.0.0",
+                "parameters": {"current_fees": {"parameters": [], "scale": 10000},
+                               "block_interval": self.interval, "maintenance_interval": 3600,
+                               "maximum_transaction_size": 98304, "maximum_block_size": 2000000,
+                               "maximum_time_until_expiration": MAX_EXPIRATION,
+                               "extensions": []},
+                "next_available_vote_id": 0, "active_committee_members": [], "active_witnesses": []}
+
+    ## Lookups:
+
+    def getObject(self, object_id):
+        if object_id == "2.0.0":
+            return self.globalProperties()
+        if object_id == "2.1.0":
+            return self.dynamicGlobalProperties()
+        if object_id in self.accounts:
+            return self.accounts[object_id]
+        if object_id in self.assets:
+            return self.assets[object_id]
+        if object_id.startswith("2.3."):
+            asset_id = "1.3." + object_id.split('.')[2]
+            if asset_id in self.assets:
+                return {"id": object_id, "current_supply": "0", "confidential_supply": "0",
+                        "accumulated_fees": "0", "fee_pool": "0"}
+        return self.fixture.get('objects', {}).get(object_id)
+
+    def account(self, name_or_id):
+        return self.accounts.get(name_or_id) or self.accountsByName.get(name_or_id)
+
+    def asset(self, symbol_or_id):
+        return self.assets.get(symbol_or_id) or self.assetsBySymbol.get(symbol_or_id)
+
+    def balances(self, account_id, asset_ids):
+        held = {b['asset_id']: b['amount'] for b in self.fixture.get('balances', {}).get(account_id, [])}
+        if not asset_ids:
+            return [{"asset_id": a, "amount": int(v)} for a, v in held.items()]
+        return [{"asset_id": a, "amount": int(held.get(a, 0))} for a in asset_ids]
+
+    def history(self, account_id, stop, limit, start):
+        # As the history API: newest first, ids in (stop, start], start 0 meaning newest.
+        stop = int(stop.split('.')[2])
+        start = int(start.split('.')[2]) or 2**62
+        items = [h for h in self.fixture.get('history', {}).get(account_id, [])
+                 if stop < int(h['id'].split('.')[2]) <= start]
+        items.sort(key=lambda h: int(h['id'].split('.')[2]), reverse=True)
+        return items[:min(limit, 100)]
+
+    def keyReferences(self, keys):
+        result = []
+        for key in keys:
+            result.append([a['id'] for a in self.accounts.values()
+                           if any(k == key for k, _ in a['owner']['key_auths'] + a['active']['key_auths'])
+                           or a['options']['memo_key'] == key])
+        return result
+
+    def requiredFees(self, ops, asset_id):
+        fees = self.fixture.get('fees', {})
+        return [{"amount": fees.get(str(op[0]), fees.get('default', 0)), "asset_id": asset_id}
+                for op in ops]
+
+    ## Broadcast:
+
+    def checkTransaction(self, tx):
+        head = self.headBlock()
+        refNum = head - ((head - tx['ref_block_num']) & 0xFFFF)
+        refId = bytes.fromhex(self.blockId(refNum))
+        if refNum < 1 or tx['ref_block_prefix'] != struct.unpack_from("<I", refId, 4)[0]:
+            raise RpcError("Assert Exception: tapos_block_summary.block_id._hash[1] == "
+                           "ref_block_prefix: ref_block_num %d is not a recent block"
+                           % tx['ref_block_num'])
+        expiration = parseIsoTime(tx['expiration'])
+        now = self.blockTime(head)
+        if expiration <= now:
+            raise RpcError("Assert Exception: trx.expiration > now: %s" % tx['expiration'])
+        if expiration > now + MAX_EXPIRATION:
+            raise RpcError("Assert Exception: trx.expiration <= now + max_time_until_expiration: %s"
+                           % tx['expiration'])
+        if not tx.get('signatures'):
+            raise RpcError("Assert Exception: missing required active authority")
+
+    def signers(self, tx):
+        try:
+            from bitsharesbase.signedtransactions import Signed_Transaction
+        except ImportError:
+            return None
+        st = Signed_Transaction(ref_block_num=tx['ref_block_num'], ref_block_prefix=tx['ref_block_prefix'],
+                                expiration=tx['expiration'], operations=tx['operations'],
+                                signatures=tx['signatures'])
+        try:
+            return [str(k) for k in st.verify(chain=self.prefix)]
+        except Exception as e:
+            raise RpcError("Assert Exception: invalid signature: %s" % e)
+
+    def broadcast(self, tx):
+        self.checkTransaction(tx)
+        record = {"received": isoTime(time.time()), "block_num": self.headBlock() + 1,
+                  "signers": self.signers(tx), "trx": tx}
+        with self.lock:
+            self.broadcasts.append(record)
+            if self.recordFile is not None:
+                self.recordFile.write(json.dumps(record) + "\n")
+                self.recordFile.flush()
+        return record
+
+    ## Dispatch:
+
+    def call(self, method, params):
+        canned = self.fixture.get('responses', {})
+        if method in canned:
+            return canned[method]
+        if method in ('login',):
+            return True
+        if method in ('get_api_by_name', 'database', 'network_broadcast', 'history'):
+            return method if method != 'get_api_by_name' else params[0]
+        if method == 'get_chain_properties':
+            return {"id": "2.11.0", "chain_id": self.chain_id,
+                    "immutable_parameters": {"min_committee_member_count": 11, "min_witness_count": 11,
+                                             "num_special_accounts": 0, "num_special_assets": 0}}
+        if method == 'get_chain_id':
+            return self.chain_id
+        if method == 'get_config':
+            return {"GRAPHENE_SYMBOL": self.asset(self.core)['symbol'] if self.asset(self.core) else "BTS",
+                    "GRAPHENE_ADDRESS_PREFIX": self.prefix,
+                    "GRAPHENE_MAX_TIME_UNTIL_EXPIRATION": MAX_EXPIRATION}
+        if method == 'get_dynamic_global_properties':
+            return self.dynamicGlobalProperties()
+        if method == 'get_global_properties':
+            return self.globalProperties()
+        if method == 'get_objects':
+            return [self.getObject(i) for i in params[0]]
+        if method in ('lookup_account_names', 'get_accounts'):
+            return [self.account(n) for n in params[0]]
+        if method == 'get_account_by_name':
+            return self.account(params[0])
+        if method == 'get_full_accounts':
+            return [[n, {"account": self.account(n),
+                         "balances": [dict(b, owner=self.account(n)['id'])
+                                      for b in self.balances(self.account(n)['id'], [])]}]
+                    for n in params[0] if self.account(n) is not None]
+        if method in ('lookup_asset_symbols', 'get_assets'):
+            return [self.asset(s) for s in params[0]]
+        if method == 'get_account_balances':
+            return self.balances(params[0], params[1])
+        if method == 'get_named_account_balances':
+            account = self.account(params[0])
+            return self.balances(account['id'], params[1]) if account else []
+        if method == 'get_account_history':
+            return self.history(*params[:4])
+        if method == 'get_key_references':
+            return self.keyReferences(params[0])
+        if method == 'get_required_fees':
+            return self.requiredFees(params[0], params[1])
+        if method in ('get_block_header', 'get_block'):
+            return self.blockHeader(int(params[0]))
+        if method == 'broadcast_transaction':
+            self.broadcast(params[0])
+            return None
+        if method == 'broadcast_transaction_synchronous':
+            record = self.broadcast(params[0])
+            return {"id": None, "block_num": record['block_num'], "trx_num": 0, "trx": params[0]}
+        if method == 'broadcast_transaction_with_callback':
+            self.broadcast(params[1])
+            return None
+        raise RpcError("Assert Exception: no method with name '%s'" % method)
+
+
+class _RpcHandler(BaseHTTPRequestHandler):
+
+    def log_message(self, format, *args):
+        if self.server.verbose:
+            super().log_message(format, *args)
+
+    def reply(self, body, status=200):
+        data = json.dumps(body).encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def do_GET(self):
+        if self.path.rstrip('/') == '/broadcasts':
+            with self.server.chain.lock:
+                self.reply(list(self.server.chain.broadcasts))
+        else:
+            self.reply({"error": "not found"}, 404)
+
+    def do_POST(self):
+        try:
+            request = json.loads(self.rfile.read(int(self.headers.get('Content-Length', 0))))
+        except ValueError:
+            self.reply({"jsonrpc": "2.0", "id": None, "error": {"code": -32700, "message": "Parse error"}})
+            return
+        method, params = request.get('method'), request.get('params', [])
+        if method == 'call':
+            # [api, method, args], the form python-bitshares sends
+            method, params = params[1], params[2]
+        self.server.calls[method] = self.server.calls.get(method, 0) + 1
+        try:
+            result = self.server.chain.call(method, params)
+        except (RpcError, LookupError, TypeError, ValueError, AttributeError) as e:
+            self.reply({"jsonrpc": "2.0", "id": request.get('id'),
+                        "error": {"code": 1, "message": str(e), "data": {"message": str(e)}}})
+            return
+        self.reply({"jsonrpc": "2.0", "id": request.get('id'), "result": result})
+
+
+class MockNodeServer(ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+    def __init__(self, chain, host='127.0.0.1', port=8090, verbose=False):
+        self.chain = chain
+        self.verbose = verbose
+        self.calls = {}         # method -> count, for benchmarks
+        super().__init__((host, port), _RpcHandler)
+
+
+def loadFixture(path=DEFAULT_FIXTURE):
+    with open(path) as f:
+        return json.load(f)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Serve a mock BitShares API node from a fixture file.")
+    parser.add_argument('--host', default='127.0.0.1', help="address to listen on")
+    parser.add_argument('--port', type=int, default=8090, help="port to listen on")
+    parser.add_argument('--fixture', default=DEFAULT_FIXTURE, help="chain fixture JSON")
+    parser.add_argument('--record', help="append broadcast transactions to JSONL file RECORD")
+    parser.add_argument('--verbose', action='store_true', help="log every request")
+    args = parser.parse_args()
+
+    chain = MockChain(loadFixture(args.fixture))
+    if args.record:
+        chain.recordFile = open(args.record, 'a')
+    server = MockNodeServer(chain, args.host, args.port, args.verbose)
+    print("Mock node for chain %s... on http://%s:%d" % ((chain.chain_id[:8],) + server.server_address),
+          flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    print("Calls: %s" % server.calls)
+    print("Broadcasts: %d" % len(chain.broadcasts))
@@ -0,0 +1,385 @@
+#!/usr/bin/env python3
+"""
+/*******************************************************************************
+*  Copyright of the Contributing Authors; see CONTRIBUTORS.md.
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+##
+## Stands in for a Nano running the BitShares app, for running the host tools
+## offline and in CI.
+##
+## Listens on TCP and speaks the framing of ledgerblue's DongleServer, so any
+## tool that opens the device with getDongle() talks to the simulator instead
+## when started with
+##
+##     LEDGER_PROXY_ADDRESS=127.0.0.1 LEDGER_PROXY_PORT=9999
+##
+## INS_SIGN streams are fed, one APDU at a time, to the app's own parser and
+## printers built for the host (host/libbtspreview.so; `make -C host`), so the
+## simulator accepts, rejects and displays exactly what the device would.  Keys
+## are derived from a BIP39 mnemonic as the device's seed, and signatures use
+## the app's RFC 6979 nonces and canonical-signature loop, so for the same seed
+## the simulator returns the same addresses and signatures as a real Nano.
+##
+## Every confirmation is approved immediately unless --decline or --review-delay
+## is given.  Not for real funds: the seed sits in host memory.
+##
+
+import argparse
+import ctypes
+import hashlib
+import hmac
+import os
+import socketserver
+import struct
+import sys
+import threading
+import time
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'SimpleGUIWallet'))
+import device_preview
+
+CLA = 0xB5
+INS_GET_PUBLIC_KEY = 0x02
+INS_SIGN = 0x04
+INS_GET_APP_CONFIGURATION = 0x06
+P1_CONFIRM = 0x01
+P1_NON_CONFIRM = 0x00
+P2_NO_CHAINCODE = 0x00
+P2_CHAINCODE = 0x01
+P2_NO_MEMO_KEY = 0x00
+P2_MEMO_KEY = 0x01
+P1_FIRST = 0x00
+P1_MORE = 0x80
+MAX_BIP32_PATH = 10
+
+SW_OK = 0x9000
+SW_DENIED = 0x6985
+SW_WRONG_DATA = 0x6A80
+SW_WRONG_P1P2 = 0x6B00
+SW_INS_NOT_SUPPORTED = 0x6D00
+SW_CLA_NOT_SUPPORTED = 0x6E00
+SW_UNKNOWN = 0x6F00
+
+APP_VERSION = (0, 0, 1)     # APPVERSION_M/N/P in the Makefile
+
+# A well-known BIP39 test mnemonic.  Anyone can spend from its keys.
+DEFAULT_MNEMONIC = ("abandon abandon abandon abandon abandon abandon "
+                    "abandon abandon abandon abandon abandon about")
+
+
+def isMemoKeyPath(path):
+    """As in src/main.c: only SLIP-0048 memo keys, 48'/network'/3'/..."""
+    return len(path) >= 3 and path[0] == 0x80000030 and path[2] == 0x80000003
+
+
+class DeviceException(Exception):
+    """Raised with a status word, as THROW() is on device."""
+    def __init__(self, sw):
+        super().__init__("SW %04x" % sw)
+        self.sw = sw
+
+
+## secp256k1, as BOLOS provides it on device.  Affine arithmetic is plenty fast
+## for a handful of signatures.
+
+P = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F
+N = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141
+G = (0x79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798,
+     0x483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8)
+
+
+def pointAdd(a, b):
+    if a is None:
+        return b
+    if b is None:
+        return a
+    if a[0] == b[0] and (a[1] + b[1]) % P == 0:
+        return None
+    if a == b:
+        slope = 3 * a[0] * a[0] * pow(2 * a[1], -1, P) % P
+    else:
+        slope = (b[1] - a[1]) * pow(b[0] - a[0], -1, P) % P
+    x = (slope * slope - a[0] - b[0]) % P
+    return (x, (slope * (a[0] - x) - a[1]) % P)
+
+
+def pointMul(k, point=G):
+    result = None
+    while k:
+        if k & 1:
+            result = pointAdd(result, point)
+        point = pointAdd(point, point)
+        k >>= 1
+    return result
+
+
+def uncompressed(point):
+    return b'\x04' + point[0].to_bytes(32, 'big') + point[1].to_bytes(32, 'big')
+
+
+def compressed(point):
+    return bytes([2 + (point[1] & 1)]) + point[0].to_bytes(32, 'big')
+
+
+def deriveNode(seed, path):
+    """BIP32 private key and chain code at `path`, as os_perso_derive_node_bip32."""
+    digest = hmac.new(b"Bitcoin seed", seed, hashlib.sha512).digest()
+    key, chainCode = int.from_bytes(digest[:32], 'big'), digest[32:]
+    for index in path:
+        if index & 0x80000000:
+            data = b'\x00' + key.to_bytes(32, 'big')
+        else:
+            data = compressed(pointMul(key))
+        digest = hmac.new(chainCode, data + struct.pack(">I", index), hashlib.sha512).digest()
+        key, chainCode = (int.from_bytes(digest[:32], 'big') + key) % N, digest[32:]
+    return key, chainCode
+
+
+def mnemonicToSeed(mnemonic, passphrase=""):
+    return hashlib.pbkdf2_hmac("sha512", mnemonic.encode("utf-8"),
+                               ("mnemonic" + passphrase).encode("utf-8"), 2048)
+
+
+## The app's own helpers, from the host library:
+
+def _library():
+    lib = device_preview.library()
+    if not hasattr(lib, '_simConfigured'):
+        lib.btsSimPublicKeyToAddress.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_uint32]
+        lib.btsSimPublicKeyToAddress.restype = ctypes.c_uint32
+        lib.btsSimNonce.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_char_p,
+                                    ctypes.c_char_p, ctypes.c_char_p]
+        lib.btsSimNonce.restype = None
+        lib.btsSimIsCanonical.argtypes = [ctypes.c_char_p]
+        lib.btsSimIsCanonical.restype = ctypes.c_int
+        lib._simConfigured = True
+    return lib
+
+
+def publicKeyToAddress(W):
+    out = ctypes.create_string_buffer(60)       # tmpCtx.publicKeyContext.address
+    if _library().btsSimPublicKeyToAddress(W, out, len(out)) == 0:
+        raise DeviceException(SW_UNKNOWN)
+    return out.value        # Up to the NUL, as set_result_get_publicKey() sends it
+
+
+def signHash(key, msgHash):
+    """
+    The 65-byte compact signature io_seproxyhal_touch_tx_ok() returns: header
+    byte 27 + 4 + parity of R.y, then r and s.  As on device, s is not
+    normalized, and nonces are drawn until the signature is canonical.
+    """
+    lib = _library()
+    nonce = ctypes.create_string_buffer(32)
+    V = ctypes.create_string_buffer(33)
+    K = ctypes.create_string_buffer(32)
+    x = key.to_bytes(32, 'big')
+    z = int.from_bytes(msgHash, 'big')
+    while True:
+        lib.btsSimNonce(nonce, msgHash, x, V, K)
+        x = None
+        k = int.from_bytes(nonce.raw, 'big')
+        if not 0 < k < N:
+            continue
+        R = pointMul(k)
+        r = R[0] % N
+        s = pow(k, -1, N) * (z + r * key) % N
+        if r == 0 or s == 0:
+            continue
+        rs = r.to_bytes(32, 'big') + s.to_bytes(32, 'big')
+        if lib.btsSimIsCanonical(rs):
+            return bytes([27 + 4 + (R[1] & 1)]) + rs
+
+
+## The app:
+
+class NanoSimulator:
+
+    def __init__(self, seed, decline=False, review_delay=0.0, data_allowed=False, verbose=False):
+        self.seed = seed
+        self.decline = decline
+        self.review_delay = review_delay
+        self.data_allowed = data_allowed
+        self.verbose = verbose
+        self.signPath = None        # Set by the first INS_SIGN APDU
+        self.stats = {'apdus': 0, 'signatures': 0, 'declined': 0, 'rejected': 0}
+
+    def log(self, message):
+        if self.verbose:
+            print(message, flush=True)
+
+    def confirm(self, screens):
+        """Shows `screens` and returns the user's decision."""
+        for label, value in screens:
+            self.log("    %-20s %s" % (label, value))
+        if self.review_delay:
+            time.sleep(self.review_delay)
+        return not self.decline
+
+    def exchange(self, apdu):
+        """Returns (response data, status word) for one command APDU."""
+        self.stats['apdus'] += 1
+        try:
+            if len(apdu) < 5 or len(apdu) != 5 + apdu[4]:
+                raise DeviceException(SW_WRONG_DATA)
+            cla, ins, p1, p2 = apdu[0], apdu[1], apdu[2], apdu[3]
+            data = apdu[5:]
+            if cla != CLA:
+                raise DeviceException(SW_CLA_NOT_SUPPORTED)
+            if ins == INS_GET_PUBLIC_KEY:
+                return self.getPublicKey(p1, p2, data), SW_OK
+            if ins == INS_SIGN:
+                return self.sign(p1, p2, data)
+            if ins == INS_GET_APP_CONFIGURATION:
+                return bytes([1 if self.data_allowed else 0]) + bytes(APP_VERSION), SW_OK
+            raise DeviceException(SW_INS_NOT_SUPPORTED)
+        except DeviceException as e:
+            return b'', e.sw
+
+    @staticmethod
+    def parsePath(data):
+        if len(data) < 1 or not 1 <= data[0] <= MAX_BIP32_PATH or len(data) < 1 + 4 * data[0]:
+            raise DeviceException(SW_WRONG_DATA)
+        count = data[0]
+        return list(struct.unpack(">%dI" % count, data[1:1 + 4 * count])), data[1 + 4 * count:]
+
+    def getPublicKey(self, p1, p2, data):
+        path, _ = self.parsePath(data)
+        if p1 not in (P1_CONFIRM, P1_NON_CONFIRM) or p2 not in (P2_CHAINCODE, P2_NO_CHAINCODE):
+            raise DeviceException(SW_WRONG_P1P2)
+        key, chainCode = deriveNode(self.seed, path)
+        W = uncompressed(pointMul(key))
+        address = publicKeyToAddress(W)
+        self.log("Public key %s" % address.decode())
+        if p1 == P1_CONFIRM and not self.confirm([("Confirm", "Address"),
+                                                  ("Address", address.decode())]):
+            raise DeviceException(SW_DENIED)
+        response = bytes([65]) + W + bytes([len(address)]) + address
+        if p2 == P2_CHAINCODE:
+            response += chainCode
+        return response
+
+    def sign(self, p1, p2, data):
+        if p2 not in (P2_NO_MEMO_KEY, P2_MEMO_KEY):
+            raise DeviceException(SW_WRONG_P1P2)
+        if p1 == P1_FIRST:
+            self.signPath, data = self.parsePath(data)
+            if p2 == P2_MEMO_KEY:
+                # Checked as on device, but memos stay encrypted: the preview
+                # library holds no keys.
+                memoPath, data = self.parsePath(data)
+                if not isMemoKeyPath(memoPath):
+                    raise DeviceException(SW_WRONG_DATA)
+            device_preview.begin()
+        elif p1 != P1_MORE:
+            raise DeviceException(SW_WRONG_P1P2)
+        if self.signPath is None:
+            raise DeviceException(SW_DENIED)
+        status = device_preview.feed(data)
+        if status == device_preview.STREAM_PROCESSING:
+            return b'', SW_OK
+        path, self.signPath = self.signPath, None
+        if status != device_preview.STREAM_FINISHED:
+            self.stats['rejected'] += 1
+            self.log("Rejected malformed transaction")
+            raise DeviceException(SW_WRONG_DATA)
+        try:
+            preview = device_preview.result()
+        except device_preview.PreviewError:
+            # On device a printer exception resets the app.
+            self.stats['rejected'] += 1
+            raise DeviceException(SW_UNKNOWN)
+        self.log("Sign TxID %s" % preview.txId)
+        if not self.confirm(preview.screens):
+            self.stats['declined'] += 1
+            raise DeviceException(SW_DENIED)
+        key, _ = deriveNode(self.seed, path)
+        self.stats['signatures'] += 1
+        return signHash(key, bytes.fromhex(preview.msgHash)), SW_OK
+
+
+class _ApduHandler(socketserver.BaseRequestHandler):
+    """One ledgerblue DongleServer connection: length-prefixed APDUs in, data + SW out."""
+
+    def recvExactly(self, count):
+        buf = b''
+        while len(buf) < count:
+            chunk = self.request.recv(count - len(buf))
+            if not chunk:
+                return None
+            buf += chunk
+        return buf
+
+    def handle(self):
+        device = self.server.device
+        while True:
+            header = self.recvExactly(4)
+            if header is None:
+                return
+            apdu = self.recvExactly(struct.unpack(">I", header)[0])
+            if apdu is None:
+                return
+            with self.server.lock:
+                response, sw = device.exchange(apdu)
+            self.request.sendall(struct.pack(">I", len(response)) + response + struct.pack(">H", sw))
+
+
+class SimulatorServer(socketserver.ThreadingMixIn, socketserver.TCPServer):
+    """
+    Serves `device` on (host, port).  Connections may overlap, as when a tool
+    reconnects, but APDUs are processed one at a time, as on the device.
+    """
+    allow_reuse_address = True
+    daemon_threads = True
+
+    def __init__(self, device, host='127.0.0.1', port=9999):
+        self.device = device
+        self.lock = threading.Lock()
+        super().__init__((host, port), _ApduHandler)
+
+
+def seedFromArgs(args):
+    if args.seed:
+        return bytes.fromhex(args.seed)
+    return mnemonicToSeed(args.mnemonic, args.passphrase)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Simulate a Nano running the BitShares app, "
+                                     "on ledgerblue's proxy (LEDGER_PROXY_ADDRESS/PORT) protocol.")
+    parser.add_argument('--host', default='127.0.0.1', help="address to listen on")
+    parser.add_argument('--port', type=int, default=9999, help="port to listen on")
+    parser.add_argument('--mnemonic', default=DEFAULT_MNEMONIC, help="BIP39 mnemonic for the device seed")
+    parser.add_argument('--passphrase', default="", help="BIP39 passphrase")
+    parser.add_argument('--seed', help="hex BIP32 seed, instead of --mnemonic")
+    parser.add_argument('--decline', action='store_true', help="decline every confirmation")
+    parser.add_argument('--review-delay', type=float, default=0.0,
+                        help="seconds to wait on each confirmation, to mimic the user")
+    parser.add_argument('--data-allowed', action='store_true', help="report the data setting as enabled")
+    parser.add_argument('--quiet', action='store_true', help="don't print screens")
+    args = parser.parse_args()
+
+    if not device_preview.isAvailable():
+        sys.exit("Preview library not found; build it with 'make -C host'.")
+    device = NanoSimulator(seedFromArgs(args), decline=args.decline, review_delay=args.review_delay,
+                           data_allowed=args.data_allowed, verbose=not args.quiet)
+    server = SimulatorServer(device, args.host, args.port)
+    print("Simulated Nano listening on %s:%d" % server.server_address, flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    print("Stats: %s" % device.stats)
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+/*******************************************************************************
+*  Copyright of the Contributing Authors; see CONTRIBUTORS.md.
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+##
+## Runs the serialize, sign and broadcast pipeline end to end with no network
+## and no device: starts mock_node.py and nano_simulator.py in-process, points
+## signTransaction.py at them, and times it.  Exits nonzero if anything the
+## simulator signed did not reach the node with a valid signature, so it can
+## gate CI.
+##
+##     make -C host && python3 host/run_e2e.py --runs 5
+##
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+HOST_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, HOST_DIR)
+import mock_node
+import nano_simulator
+
+REPO_DIR = os.path.dirname(HOST_DIR)
+
+
+def parsePath(path):
+    return [int(e.rstrip("'")) | (0x80000000 if e.endswith("'") else 0) for e in path.split('/')]
+
+
+def serve(server):
+    thread = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+    return server
+
+
+def runOnce(args, nodeUrl, env):
+    with tempfile.NamedTemporaryFile('r', suffix='.jsonl') as out:
+        command = [sys.executable, os.path.join(REPO_DIR, 'signTransaction.py'),
+                   '--batch', args.batch, '--out', out.name, '--path', args.path,
+                   '--node', nodeUrl, '--tapos', '--expire', '30', '--broadcast']
+        if args.align:
+            command.append('--align')
+        start = time.perf_counter()
+        result = subprocess.run(command, env=env, cwd=REPO_DIR,
+                                stdout=None if args.verbose else subprocess.DEVNULL)
+        seconds = time.perf_counter() - start
+        records = [json.loads(line) for line in out if line.strip()]
+    return result.returncode, seconds, records
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Benchmark signTransaction.py against a mock node and simulated Nano.")
+    parser.add_argument('--batch', default=os.path.join(REPO_DIR, 'example-tx'),
+                        help="directory or JSONL file of transactions to sign")
+    parser.add_argument('--runs', type=int, default=3, help="number of times to run the batch")
+    parser.add_argument('--path', default="48'/1'/1'/0'/0'", help="SLIP-0048 path to sign with")
+    parser.add_argument('--fixture', default=mock_node.DEFAULT_FIXTURE, help="chain fixture JSON")
+    parser.add_argument('--mnemonic', default=nano_simulator.DEFAULT_MNEMONIC, help="simulated device's BIP39 mnemonic")
+    parser.add_argument('--review-delay', type=float, default=0.0, help="simulated user review time per transaction")
+    parser.add_argument('--align', action='store_true', help="align APDU boundaries to TLV fields")
+    parser.add_argument('--json', action='store_true', help="print the summary as JSON")
+    parser.add_argument('--verbose', action='store_true', help="show signTransaction.py output and device screens")
+    args = parser.parse_args()
+
+    if not nano_simulator.device_preview.isAvailable():
+        sys.exit("Preview library not found; build it with 'make -C host'.")
+
+    chain = mock_node.MockChain(mock_node.loadFixture(args.fixture))
+    node = serve(mock_node.MockNodeServer(chain, port=0, verbose=args.verbose))
+    seed = nano_simulator.mnemonicToSeed(args.mnemonic)
+    device = nano_simulator.NanoSimulator(seed, review_delay=args.review_delay, verbose=args.verbose)
+    dongle = serve(nano_simulator.SimulatorServer(device, port=0))
+    nodeUrl = "http://%s:%d" % node.server_address
+
+    key, _ = nano_simulator.deriveNode(seed, parsePath(args.path))
+    signer = nano_simulator.publicKeyToAddress(
+        nano_simulator.uncompressed(nano_simulator.pointMul(key))).decode()
+
+    env = dict(os.environ, LEDGER_PROXY_ADDRESS=dongle.server_address[0],
+               LEDGER_PROXY_PORT=str(dongle.server_address[1]))
+    runs = []
+    failed = False
+    for run in range(args.runs):
+        before = len(chain.broadcasts)
+        returncode, seconds, records = runOnce(args, nodeUrl, env)
+        signed = [r for r in records if 'signature' in r]
+        broadcasts = chain.broadcasts[before:]
+        badSigners = [b for b in broadcasts if b['signers'] is not None and signer not in b['signers']]
+        ok = returncode == 0 and len(broadcasts) == len(signed) and not badSigners
+        failed = failed or not ok
+        runs.append({'run': run + 1, 'ok': ok, 'seconds': round(seconds, 3),
+                     'signed': len(signed), 'rejected': len(records) - len(signed),
+                     'broadcast': len(broadcasts), 'apdus': sum(r.get('apdus', 0) for r in signed),
+                     'deviceSeconds': round(sum(r.get('seconds', 0) for r in signed), 3)})
+
+    summary = {'signer': signer, 'runs': runs, 'nodeCalls': node.calls, 'device': device.stats,
+               'signaturesVerified': any(b['signers'] is not None for b in chain.broadcasts)}
+    if args.json:
+        print(json.dumps(summary, indent=2))
+    else:
+        for r in runs:
+            print("Run %(run)d: %(seconds).3f s, %(signed)d signed, %(rejected)d rejected, "
+                  "%(broadcast)d broadcast, %(apdus)d APDUs, %(deviceSeconds).3f s on device"
+                  % r + ("" if r['ok'] else "  FAILED"))
+        print("Node calls: %s" % ", ".join("%s %d" % kv for kv in sorted(node.calls.items())))
+        if not summary['signaturesVerified']:
+            print("Signatures not verified: bitsharesbase is not installed.")
+    node.shutdown()
+    dongle.shutdown()
+    sys.exit(1 if failed else 0)
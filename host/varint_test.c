@@ -0,0 +1,262 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+/**
+ * Differential test and microbenchmark for unpack_varint32/48 (bts_types.c),
+ * against the unbounded decoders they replaced, kept here verbatim.  Where the
+ * old decoder stays within the input, the new one must agree with it exactly;
+ * where the old one would have read past the end, the new one must report
+ * truncation (inLength + 1) instead.
+ *
+ *   make -C host test     # exhaustive to two bytes, then random inputs
+ *   make -C host bench    # ns per decode, old and new
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bts_types.h"
+
+#define PAD 16              // Old decoders read up to 7 bytes with no bound
+#define RANDOM_CASES 1000000
+
+static uint32_t old_unpack_varint32(const uint8_t *in, uint32_t *value) {
+    uint32_t i = 0;
+    uint64_t v = 0; char b = 0; uint8_t by = 0;
+    do {
+        b = *in; ++in; ++i;
+        v |= (uint64_t)((uint8_t)b & 0x7f) << by;
+        by += 7;
+    } while( ((uint8_t)b) & 0x80 && by < 35 );
+
+    if( ((uint8_t)b) & 0x80 ) {         // Didn't hit terminating byte
+      return 0;
+    }
+    if ( v>>32 != 0 ) {                 // Too big
+      return 0;
+    }
+
+    *value = v;
+    return i;
+}
+
+static uint32_t old_unpack_varint48(const uint8_t *in, uint64_t *value) {
+    uint32_t i = 0;
+    uint64_t v = 0; char b = 0; uint8_t by = 0;
+    do {
+        b = *in; ++in; ++i;
+        v |= (uint64_t)((uint8_t)b & 0x7f) << by;
+        by += 7;
+    } while( ((uint8_t)b) & 0x80 && by < 49 );
+
+    if( ((uint8_t)b) & 0x80 ) {         // Didn't hit terminating byte
+      return 0;
+    }
+    if ( v>>48 != 0 ) {                 // Too big
+      return 0;
+    }
+
+    *value = v;
+    return i;
+}
+
+/* Bytes the old decoders read from `in`: up to the terminator, at most maxBytes. */
+static uint32_t oldBytesRead(const uint8_t *in, uint32_t maxBytes) {
+    uint32_t i = 0;
+    while (i < maxBytes - 1 && (in[i] & 0x80)) {
+        i++;
+    }
+    return i + 1;
+}
+
+static unsigned long failures = 0;
+
+static void report(const char *decoder, const uint8_t *in, uint32_t length,
+                   uint32_t expected, uint64_t expectedValue, uint32_t got, uint64_t gotValue) {
+    uint32_t i;
+    if (++failures > 20) {
+        return;
+    }
+    printf("FAIL %s [", decoder);
+    for (i = 0; i < length; i++) {
+        printf("%s%02x", i ? " " : "", in[i]);
+    }
+    printf("]: expected %u (%llu), got %u (%llu)\n", expected, (unsigned long long)expectedValue,
+           got, (unsigned long long)gotValue);
+}
+
+/* `in` must have PAD readable bytes past `length`, for the old decoders. */
+static void check(const uint8_t *in, uint32_t length) {
+    uint32_t expected, got;
+    uint32_t old32 = 0, new32 = 0;
+    uint64_t old48 = 0, new48 = 0;
+
+    expected = (oldBytesRead(in, 5) > length) ? length + 1 : old_unpack_varint32(in, &old32);
+    got = unpack_varint32(in, length, &new32);
+    if (got != expected || (expected != 0 && expected <= length && new32 != old32)) {
+        report("unpack_varint32", in, length, expected, old32, got, new32);
+    }
+
+    expected = (oldBytesRead(in, 7) > length) ? length + 1 : old_unpack_varint48(in, &old48);
+    got = unpack_varint48(in, length, &new48);
+    if (got != expected || (expected != 0 && expected <= length && new48 != old48)) {
+        report("unpack_varint48", in, length, expected, old48, got, new48);
+    }
+}
+
+/* Each decoder must give exactly `expected` for these, whatever the old ones did. */
+static void checkCase(const char *name, const uint8_t *in, uint32_t length,
+                      uint32_t expected32, uint32_t expected48) {
+    uint32_t v32 = 0;
+    uint64_t v48 = 0;
+    if (unpack_varint32(in, length, &v32) != expected32
+        || unpack_varint48(in, length, &v48) != expected48) {
+        printf("FAIL %s\n", name);
+        failures++;
+    }
+}
+
+static int runTest(void) {
+    uint8_t in[2 + PAD];
+    uint8_t buffer[10 + PAD];
+    uint32_t a, b, n, length, i;
+
+    memset(in, 0, sizeof(in));
+    memset(buffer, 0, sizeof(buffer));
+
+    // Every input of up to two bytes: the unrolled fast paths, and truncation
+    // within them.  The byte past the input varies too, so a decoder that reads
+    // it can't pass by luck.
+    for (a = 0; a < 256; a++) {
+        in[0] = a;
+        for (b = 0; b < 256; b++) {
+            in[1] = b;
+            in[2] = 0x00; check(in, 0); check(in, 1); check(in, 2);
+            in[2] = 0xff; check(in, 0); check(in, 1); check(in, 2);
+        }
+    }
+
+    // Random inputs up to ten bytes, mostly continuation bytes, so that long,
+    // overlong, and unterminated encodings are common.
+    srand(1);
+    for (n = 0; n < RANDOM_CASES; n++) {
+        length = rand() % 11;
+        for (i = 0; i < length + PAD; i++) {
+            buffer[i] = (rand() % 4) ? (rand() | 0x80) : rand() & 0x7f;
+        }
+        check(buffer, length);
+    }
+
+    checkCase("one byte", (const uint8_t *)"\x7f", 1, 1, 1);
+    checkCase("two bytes", (const uint8_t *)"\xff\x7f", 2, 2, 2);
+    checkCase("empty input truncated", (const uint8_t *)"", 0, 1, 1);
+    checkCase("one byte truncated", (const uint8_t *)"\x80", 1, 2, 2);
+    checkCase("two bytes truncated", (const uint8_t *)"\x80\x80", 2, 3, 3);
+    checkCase("2^32 - 1", (const uint8_t *)"\xff\xff\xff\xff\x0f", 5, 5, 5);
+    checkCase("2^32 overflows 32", (const uint8_t *)"\x80\x80\x80\x80\x10", 5, 0, 5);
+    checkCase("unterminated at 5 bytes", (const uint8_t *)"\x80\x80\x80\x80\x80\x00", 6, 0, 6);
+    checkCase("2^48 overflows 48", (const uint8_t *)"\x80\x80\x80\x80\x80\x80\x40", 7, 0, 0);
+    checkCase("unterminated at 7 bytes", (const uint8_t *)"\x80\x80\x80\x80\x80\x80\x80\x00", 8, 0, 0);
+
+    if (failures > 0) {
+        printf("%lu failures\n", failures);
+        return 1;
+    }
+    printf("unpack_varint32/48 agree with the old decoders\n");
+    return 0;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+#define BENCH_VALUES 4096
+#define BENCH_ROUNDS 2000
+
+static uint8_t benchInput[BENCH_VALUES][PAD];
+static volatile uint64_t sink;
+
+/* Encodes `value` into benchInput[n], padded with zeros. */
+static void encodeBenchValue(uint32_t n, uint64_t value) {
+    uint32_t i = 0;
+    do {
+        benchInput[n][i] = (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+        value >>= 7;
+        i++;
+    } while (value != 0);
+}
+
+static void benchmark(const char *mix, uint32_t maxValue) {
+    double start, oldTime, newTime;
+    uint32_t round, n, v32;
+    uint64_t v48, total;
+
+    srand(1);
+    memset(benchInput, 0, sizeof(benchInput));
+    for (n = 0; n < BENCH_VALUES; n++) {
+        encodeBenchValue(n, (uint32_t)rand() % maxValue);
+    }
+
+    total = 0;
+    start = now();
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        for (n = 0; n < BENCH_VALUES; n++) {
+            total += old_unpack_varint32(benchInput[n], &v32);
+            total += v32;
+            total += old_unpack_varint48(benchInput[n], &v48);
+            total += v48;
+        }
+    }
+    oldTime = now() - start;
+    sink = total;
+
+    total = 0;
+    start = now();
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        for (n = 0; n < BENCH_VALUES; n++) {
+            total += unpack_varint32(benchInput[n], PAD, &v32);
+            total += v32;
+            total += unpack_varint48(benchInput[n], PAD, &v48);
+            total += v48;
+        }
+    }
+    newTime = now() - start;
+    sink = total;
+
+    printf("%-28s old %5.2f ns  new %5.2f ns  per decode\n", mix,
+           oldTime * 1e9 / (2.0 * BENCH_ROUNDS * BENCH_VALUES),
+           newTime * 1e9 / (2.0 * BENCH_ROUNDS * BENCH_VALUES));
+}
+
+static int runBenchmark(void) {
+    benchmark("1 byte (< 128)", 128);
+    benchmark("1-2 bytes (< 16384)", 16384);
+    benchmark("1-3 bytes (< 2^21)", 1u << 21);
+    benchmark("1-5 bytes (< 2^32)", 0xffffffffu);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runBenchmark();
+    }
+    return runTest();
+}
@@ -19,12 +19,17 @@
 
 import binascii
 import json
+import os
 import struct
-from asn1 import Encoder, Numbers
+import sys
 from bitsharesbase.signedtransactions import Signed_Transaction
-from ledgerblue.comm import getDongle
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), 'SimpleGUIWallet'))
+from nano_session import NanoSession
+from apdu_chunking import chunkTxForSigning, sendSignApdus
+from tlv_encoder import encodeTlvTx
+import device_preview
 import argparse
-from bitshares import BitShares
+from ledgerblue.commException import CommException
 from datetime import datetime, timedelta
 
 def parse_bip32_path(path):
@@ -40,35 +45,49 @@ def parse_bip32_path(path):
             result = result + struct.pack(">I", 0x80000000 | int(element[0]))
     return result
 
-def encode(chain_id, tx):
-    encoder = Encoder()
-
-    encoder.start()
-
-    encoder.write(struct.pack(str(len(chain_id)) + 's', chain_id), Numbers.OctetString)
-    encoder.write(bytes(tx['ref_block_num']), Numbers.OctetString)
-    encoder.write(bytes(tx['ref_block_prefix']), Numbers.OctetString)
-    encoder.write(bytes(tx['expiration']), Numbers.OctetString)
-    encoder.write(bytes(tx['operations'].length), Numbers.OctetString)
-    for opIdx in range(0, len(tx.toJson()['operations'])):
-        encoder.write(bytes([tx['operations'].data[opIdx].opId]), Numbers.OctetString)
-        encoder.write(bytes(tx['operations'].data[opIdx].op), Numbers.OctetString)
-
-    if 'extension' in tx:
-        encoder.write(bytes(tx['extension']), Numbers.OctetString)
+def load_transactions(args):
+    """
+    Yields (name, tx_dict) for each transaction to sign: the single --file, or
+    every *.json file in a --batch directory, or every line of a --batch JSONL
+    file ('-' for stdin).
+    """
+    if args.batch is None:
+        with open(args.file) as f:
+            yield args.file, json.load(f)
+    elif os.path.isdir(args.batch):
+        for name in sorted(os.listdir(args.batch)):
+            if name.endswith('.json'):
+                path = os.path.join(args.batch, name)
+                with open(path) as f:
+                    yield path, json.load(f)
     else:
-        encoder.write(bytes([0]), Numbers.OctetString)
-
-    return encoder.output()
+        f = sys.stdin if args.batch == '-' else open(args.batch)
+        for lineno, line in enumerate(f, 1):
+            if line.strip():
+                yield "%s:%d" % (args.batch, lineno), json.loads(line)
+
+def apply_tapos(obj, txbuffer, expire):
+    obj['ref_block_num'] = txbuffer['ref_block_num']
+    obj['ref_block_prefix'] = txbuffer['ref_block_prefix']
+    expiration = txbuffer['expiration']
+    if expire and int(expire) >= 1:
+        expiration = datetime.strptime(expiration, "%Y-%m-%dT%H:%M:%S") + timedelta(minutes=int(expire)-1, seconds=30)
+        expiration = expiration.strftime("%Y-%m-%dT%H:%M:%S%Z")
+    obj['expiration'] = expiration
 
 parser = argparse.ArgumentParser()
-parser.add_argument('--chain_id', help="use a custom Chain ID")
+parser.add_argument('--chain_id', help="use a custom Chain ID (no network connection needed unless --tapos or --broadcast)")
 parser.add_argument('--path', help="SLIP-0048 path to use for signing")
+parser.add_argument('--memo-path', help="SLIP-0048 path of a memo key, so that the Nano can decrypt transfer memos for review")
 parser.add_argument('--file', help="read transaction from JSON-formatted FILE")
+parser.add_argument('--batch', help="sign every *.json file in directory BATCH, or every line of JSONL file BATCH ('-' for stdin)")
+parser.add_argument('--out', help="in batch mode, append JSONL signature records to OUT instead of stdout")
 parser.add_argument('--broadcast', help="broadcast transaction to network after signing", action='store_true')
 parser.add_argument('--node', help="set node to be used for broadcast")
 parser.add_argument('--tapos', help="get recent TaPOS block from network", action='store_true')
 parser.add_argument('--expire', help="set the transaction expiration to [minutes] in the future")
+parser.add_argument('--align', help="align APDU boundaries to TLV field boundaries", action='store_true')
+parser.add_argument('--preview', help="print the screens the Nano will show, using host/libbtspreview.so, and exit without signing", action='store_true')
 args = parser.parse_args()
 
 if args.path is None:
@@ -81,53 +100,94 @@ if args.node is None:
     args.node = 'wss://bitshares.openledger.info/ws'
 
 donglePath = parse_bip32_path(args.path)
-pathSize = int(len(donglePath) / 4)
+memoPath = parse_bip32_path(args.memo_path) if args.memo_path else None
 
-with open(args.file) as f:
-    obj = json.load(f)
+blockchain = None
+if args.tapos or args.broadcast or args.chain_id is None:
+    from bitshares import BitShares
     blockchain = BitShares(args.node)
-    if args.tapos:
-        txbuffer = blockchain.tx()
-        obj['ref_block_num'] = txbuffer['ref_block_num']
-        obj['ref_block_prefix'] = txbuffer['ref_block_prefix']
-        if args.expire and int(args.expire) >= 1:
-            expiration = datetime.strptime(txbuffer['expiration'], "%Y-%m-%dT%H:%M:%S") + timedelta(minutes=int(args.expire)-1, seconds=30)
-            txbuffer['expiration'] = expiration.strftime("%Y-%m-%dT%H:%M:%S%Z")
-        obj['expiration'] = txbuffer['expiration']
+if args.chain_id is None:
+    args.chain_id = blockchain.rpc.chain_params['chain_id']
+chain_id = binascii.unhexlify(args.chain_id)
+
+# Serialize everything up front, so that once we start talking to the device
+# we can sign back to back.  TaPoS, if requested, is fetched once for the batch.
+txbuffer = blockchain.tx() if args.tapos else None
+jobs = []
+for name, obj in load_transactions(args):
+    if txbuffer is not None:
+        apply_tapos(obj, txbuffer, args.expire)
     tx = Signed_Transaction(
             ref_block_num=obj['ref_block_num'],
             ref_block_prefix=obj['ref_block_prefix'],
             expiration=obj['expiration'],
             operations=obj['operations'],
         )
-    if args.chain_id is None:
-        args.chain_id = blockchain.rpc.chain_params['chain_id']
-    signData = encode(binascii.unhexlify(args.chain_id), tx)
-    print (binascii.hexlify(signData).decode())
-
-    dongle = getDongle(True)
-    offset = 0
-    first = True
-    singSize = len(signData)
-    while offset != singSize:
-        if singSize - offset > 200:
-            chunk = signData[offset: offset + 200]
-        else:
-            chunk = signData[offset:]
-
-        if first:
-            totalSize = len(donglePath) + 1 + len(chunk)
-            apdu = binascii.unhexlify("B5040000" + "{:02x}".format(totalSize) + "{:02x}".format(pathSize)) + donglePath + chunk
-            first = False
-        else:
-            totalSize = len(chunk)
-            apdu = binascii.unhexlify("B5048000" + "{:02x}".format(totalSize)) + chunk
-
-        offset += len(chunk)
-        result = dongle.exchange(apdu)
-        print (binascii.hexlify(result).decode())
+    signData = encodeTlvTx(chain_id, tx)
+    jobs.append((name, tx, signData))
+
+if args.batch is None:
+    print (binascii.hexlify(jobs[0][2]).decode())
+out = open(args.out, 'a') if args.out else sys.stdout
+
+# Check each transaction against the app's own parser, built for the host, so
+# the device never sees one it would reject.  Optional unless --preview.
+if args.preview and not device_preview.isAvailable():
+    sys.exit("Preview library not found; build it with 'make -C host'.")
+if device_preview.isAvailable():
+    checked = []
+    for name, tx, signData in jobs:
+        try:
+            preview = device_preview.preview(signData)
+            if preview.unsupportedOps:
+                raise device_preview.PreviewError("Unsupported operation(s) %s"
+                    % ", ".join(str(i + 1) for i in preview.unsupportedOps))
+        except device_preview.PreviewError as e:
+            if args.batch is None:
+                sys.exit("Nano would reject transaction: %s" % e)
+            out.write(json.dumps({'tx': name, 'error': 'rejected', 'reason': str(e)}) + "\n")
+            continue
+        if args.preview:
+            print ("%s (TxID %s):" % (name, preview.txId))
+            for label, value in preview.screens:
+                print ("    %-20s %s" % (label, value))
+        checked.append((name, tx, signData))
+    out.flush()
+    jobs = checked
+    if args.preview:
+        sys.exit(0)
+
+session = NanoSession(True).open()
+for name, tx, signData in jobs:
+    apdus = chunkTxForSigning(signData, donglePath, align_fields=args.align, memoPath=memoPath)
+    try:
+        result, stats = sendSignApdus(session, apdus)
+    except CommException as e:
+        if args.batch is None or e.sw != 0x6985:
+            raise
+        # User declined this one; record it and carry on with the batch.
+        out.write(json.dumps({'tx': name, 'error': 'declined'}) + "\n")
+        out.flush()
+        continue
+    signature = binascii.hexlify(result).decode()
+    if args.batch is None:
+        print (signature)
+        print ("Sent %d tx bytes in %d APDUs; %.2f s including user review."
+               % (len(signData), stats.apduCount, stats.seconds))
+    else:
+        out.write(json.dumps({'tx': name, 'signature': signature,
+                              'apdus': stats.apduCount, 'seconds': round(stats.seconds, 3)}) + "\n")
+        out.flush()
     if args.broadcast:
         tx_sig = blockchain.new_tx(json.loads(str(tx)))
-        tx_sig["signatures"].extend([binascii.hexlify(result).decode()])
-        print (tx_sig)
-        print (blockchain.broadcast(tx=tx_sig))
+        tx_sig["signatures"].extend([signature])
+        if args.batch is None:
+            print (tx_sig)
+            print (blockchain.broadcast(tx=tx_sig))
+        else:
+            out.write(json.dumps({'tx': name, 'broadcast': blockchain.broadcast(tx=tx_sig)},
+                                 default=str) + "\n")
+            out.flush()
+session.close()
+if out is not sys.stdout:
+    out.close()
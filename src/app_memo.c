@@ -0,0 +1,424 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "os.h"
+#include "cx.h"
+
+#include "app_memo.h"
+#include "app_ux.h"
+#include "bts_t_memo.h"
+#include "eos_utils.h"
+#include <string.h>
+
+/**
+ * Memo encryption and decryption.  Follows graphene's memo_data: the
+ * AES-256-CBC key and IV are the first 32 and next 16 bytes of
+ *
+ *     sha512(decimal(nonce) + hex(sha512(x of ECDH(memo key, other party's key))))
+ *
+ * and the plaintext is a four-byte checksum then the text.
+ *
+ * Decryption, for the Memo argument of transfers, uses the memo key derived from
+ * the path the host sends with the transaction (INS_SIGN, P2 = 01).  It streams
+ * one AES block at a time from the cached operation payload straight into the
+ * display buffer, so RAM use does not depend on memo length.
+ *
+ * Encryption (INS_ENCRYPT_MEMO) streams the other way: the host sends the text
+ * in chunks and gets back the ciphertext of every whole block as soon as it has
+ * one.  The checksum leads the plaintext, so the host sends it up front (it is
+ * just a hash of the text, and no secret), and we check it against our own hash
+ * of the text before releasing the last block.
+ */
+
+static const uint8_t SECP256K1_P[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                      0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfc, 0x2f};
+
+// (p + 1) / 4: since p = 3 mod 4, a^((p+1)/4) is a square root of a mod p.
+static const uint8_t SECP256K1_SQRT_EXP[] = {0x3f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                             0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                             0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                             0xff, 0xff, 0xff, 0xff, 0xbf, 0xff, 0xff, 0x0c};
+
+static bool encrypting;     // tmpCtx.memoContext is live (outside tmpCtx, which
+                            // other instructions overwrite)
+
+/**
+ * Expands a compressed public key to the uncompressed point cx_ecdh() takes, by
+ * solving y^2 = x^3 + 7 and choosing the root with the parity of the prefix.
+ * Returns false if the key is not on the curve.
+ */
+static bool decompressPublicKey(const bts_public_key_type_t *key, uint8_t point[65]) {
+    uint8_t rhs[32];
+    uint8_t check[32];
+    if (key->h[0] != 0x02 && key->h[0] != 0x03) {
+        return false;
+    }
+    os_memset(rhs, 0, sizeof(rhs));
+    rhs[31] = 7;
+    point[0] = 0x04;
+    os_memmove(point + 1, key->x, 32);
+    cx_math_multm(point + 33, point + 1, point + 1, SECP256K1_P, 32);
+    cx_math_multm(point + 33, point + 33, point + 1, SECP256K1_P, 32);
+    cx_math_addm(rhs, point + 33, rhs, SECP256K1_P, 32);
+    cx_math_powm(point + 33, rhs, SECP256K1_SQRT_EXP, 32, SECP256K1_P, 32);
+    // x^3 + 7 has no root if x is not on the curve:
+    cx_math_multm(check, point + 33, point + 33, SECP256K1_P, 32);
+    if (os_memcmp(check, rhs, sizeof(check)) != 0) {
+        return false;
+    }
+    if ((point[64] & 1) != (key->h[0] & 1)) {
+        cx_math_sub(point + 33, SECP256K1_P, point + 33, 32);
+    }
+    return true;
+}
+
+/**
+ * Derives the memo key at `path`, and writes its public key, compressed, to
+ * `ourKey`.
+ */
+static void deriveMemoKey(const uint32_t *path, uint8_t pathLength,
+                          cx_ecfp_private_key_t *privateKey, bts_public_key_type_t *ourKey) {
+    uint8_t privateKeyData[64];
+    cx_ecfp_public_key_t publicKey;
+
+    os_perso_derive_node_bip32(CX_CURVE_256K1, (uint32_t *)path, pathLength, privateKeyData, NULL);
+    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, privateKey);
+    os_memset(privateKeyData, 0, sizeof(privateKeyData));
+    cx_ecfp_generate_pair(CX_CURVE_256K1, &publicKey, privateKey, 1);
+    ourKey->h[0] = 0x02 | (publicKey.W[64] & 1);
+    os_memmove(ourKey->x, publicKey.W + 1, 32);
+}
+
+//
+// Shared secret cache:
+//
+// Batches of memos tend to go to the same few counterparties, and each would
+// otherwise cost a key derivation and a scalar multiplication.  So we keep the
+// last few ECDH results, most recently used first, keyed by a hash of the memo
+// key path and the counterparty's key.  They live only in RAM, for as long as
+// the app runs, and memoSecretCacheWipe() clears them on exit.
+//
+
+#ifndef MEMO_SECRET_CACHE_SIZE
+#define MEMO_SECRET_CACHE_SIZE 4
+#endif
+
+typedef struct memoSecret_t {
+    uint8_t tag[16];                // sha256(memo key path, counterparty key)
+    bts_public_key_type_t ourKey;   // Memo key at that path
+    uint8_t sharedX[32];            // x of ECDH(memo key, counterparty key)
+} memoSecret_t;
+
+static memoSecret_t secretCache[MEMO_SECRET_CACHE_SIZE];
+static uint8_t cachedSecrets;       // Entries of secretCache in use
+
+static void memoSecretTag(const uint32_t *path, uint8_t pathLength,
+                          const bts_public_key_type_t *counterparty, uint8_t tag[16]) {
+    cx_sha256_t sha256;
+    uint8_t digest[32];
+    cx_sha256_init(&sha256);
+    cx_hash(&sha256.header, 0, (const uint8_t *)path, pathLength * sizeof(uint32_t), NULL);
+    cx_hash(&sha256.header, CX_LAST, (const uint8_t *)counterparty, sizeof(bts_public_key_type_t), digest);
+    os_memmove(tag, digest, 16);
+}
+
+/**
+ * Looks up the secret for `tag`, and if it is there, and the memo key it was
+ * computed with is `ourKey` (or `ourKey` is NULL), writes it to `sharedX` and
+ * makes it the most recently used.
+ */
+static bool findMemoSecret(const uint8_t tag[16], const bts_public_key_type_t *ourKey,
+                           uint8_t sharedX[32]) {
+    memoSecret_t hit;
+    for (uint32_t i = 0; i < cachedSecrets; i++) {
+        if (os_memcmp(secretCache[i].tag, tag, sizeof(hit.tag)) != 0) {
+            continue;
+        }
+        if (ourKey != NULL && os_memcmp(&secretCache[i].ourKey, ourKey, sizeof(hit.ourKey)) != 0) {
+            return false;
+        }
+        os_memmove(&hit, &secretCache[i], sizeof(hit));
+        os_memmove(&secretCache[1], &secretCache[0], i * sizeof(memoSecret_t));
+        os_memmove(&secretCache[0], &hit, sizeof(hit));
+        os_memmove(sharedX, hit.sharedX, sizeof(hit.sharedX));
+        os_memset(&hit, 0, sizeof(hit));
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Computes the secret of our memo key with `counterparty` into `sharedX`, and
+ * caches it under `tag`, evicting the least recently used if the cache is full.
+ * Returns false if `counterparty` is not a valid key.
+ */
+static bool computeMemoSecret(const cx_ecfp_private_key_t *privateKey,
+                              const bts_public_key_type_t *ourKey,
+                              const bts_public_key_type_t *counterparty,
+                              const uint8_t tag[16], uint8_t sharedX[32]) {
+    uint8_t point[65];
+    uint8_t shared[65];
+    const uint32_t kept = MIN(cachedSecrets, MEMO_SECRET_CACHE_SIZE - 1);
+
+    if (!decompressPublicKey(counterparty, point)) {
+        return false;
+    }
+    cx_ecdh((cx_ecfp_private_key_t *)privateKey, CX_ECDH_POINT, point, shared);
+    os_memmove(sharedX, shared + 1, 32);
+    os_memset(shared, 0, sizeof(shared));
+
+    os_memmove(&secretCache[1], &secretCache[0], kept * sizeof(memoSecret_t));
+    cachedSecrets = kept + 1;
+    os_memmove(secretCache[0].tag, tag, sizeof(secretCache[0].tag));
+    os_memmove(&secretCache[0].ourKey, ourKey, sizeof(bts_public_key_type_t));
+    os_memmove(secretCache[0].sharedX, sharedX, 32);
+    return true;
+}
+
+void memoSecretCacheWipe() {
+    os_memset(secretCache, 0, sizeof(secretCache));
+    cachedSecrets = 0;
+}
+
+/**
+ * Computes the AES key (seed[0..31]) and IV (seed[32..47]) from the shared
+ * secret and the nonce.
+ */
+static void memoCipherSeed(const uint8_t sharedX[32], uint64_t nonce, uint8_t seed[64]) {
+    cx_sha512_t sha512;
+    char text[33];      // Nonce in decimal, or 16 bytes of secret in hex
+
+    cx_sha512_init(&sha512);
+    cx_hash(&sha512.header, CX_LAST, sharedX, 32, seed);
+
+    cx_sha512_init(&sha512);
+    ui64toa(nonce, text);
+    cx_hash(&sha512.header, 0, (const uint8_t *)text, strlen(text), NULL);
+    for (uint32_t i = 0; i < 64; i += 16) {
+        array_hexstr(text, seed + i, 16);
+        cx_hash(&sha512.header, 0, (const uint8_t *)text, 32, NULL);
+    }
+    cx_hash(&sha512.header, CX_LAST, NULL, 0, seed);
+    os_memset(text, 0, sizeof(text));
+}
+
+/**
+ * Finds the secret the memo key at `path` shares with whichever of the memo's
+ * keys is not its own.  Returns false if the memo key is neither of them.
+ */
+static bool memoSharedSecret(const uint32_t *path, uint8_t pathLength,
+                             const bts_memo_type_t *memo, uint8_t sharedX[32]) {
+    uint8_t toTag[16];      // For us as sender
+    uint8_t fromTag[16];    // For us as recipient
+    cx_ecfp_private_key_t privateKey;
+    bts_public_key_type_t ourKey;
+    bool found = false;
+
+    memoSecretTag(path, pathLength, &memo->toPubkey, toTag);
+    memoSecretTag(path, pathLength, &memo->fromPubkey, fromTag);
+    if (findMemoSecret(toTag, &memo->fromPubkey, sharedX)
+        || findMemoSecret(fromTag, &memo->toPubkey, sharedX)) {
+        return true;
+    }
+    deriveMemoKey(path, pathLength, &privateKey, &ourKey);
+    if (os_memcmp(&ourKey, &memo->fromPubkey, sizeof(ourKey)) == 0) {
+        found = computeMemoSecret(&privateKey, &ourKey, &memo->toPubkey, toTag, sharedX);
+    } else if (os_memcmp(&ourKey, &memo->toPubkey, sizeof(ourKey)) == 0) {
+        found = computeMemoSecret(&privateKey, &ourKey, &memo->fromPubkey, fromTag, sharedX);
+    }
+    os_memset(&privateKey, 0, sizeof(privateKey));
+    return found;
+}
+
+bool decryptBtsMemo(const bts_memo_type_t *memo, char *buffer, size_t bufferLength) {
+    uint8_t sharedX[32];
+    uint8_t seed[64];
+    cx_aes_key_t aesKey;
+    cx_sha256_t sha256;
+    uint8_t block[AES_BLOCK_LENGTH];
+    uint8_t checksum[BTS_MEMO_CHECKSUM_LENGTH];
+    const uint32_t blocks = memo->cipherTextLength / AES_BLOCK_LENGTH;
+    const uint8_t *chain;
+    uint32_t plainLength = 0;
+    size_t written = 0;
+    bool padded = true;
+
+    if (tmpCtx.transactionContext.memoPathLength == 0
+        || blocks == 0 || memo->cipherTextLength % AES_BLOCK_LENGTH != 0) {
+        return false;
+    }
+    if (!memoSharedSecret(tmpCtx.transactionContext.memoPath,
+                          tmpCtx.transactionContext.memoPathLength, memo, sharedX)) {
+        return false;
+    }
+    memoCipherSeed(sharedX, memo->nonce, seed);
+    os_memset(sharedX, 0, sizeof(sharedX));
+    cx_aes_init_key(seed, 32, &aesKey);
+    cx_sha256_init(&sha256);
+    buffer[0] = 0;
+
+    chain = seed + 32;  // IV
+    for (uint32_t b = 0; b < blocks; b++) {
+        const uint8_t *cipher = memo->cipherText + b * AES_BLOCK_LENGTH;
+        uint32_t length = AES_BLOCK_LENGTH;
+        uint32_t start = 0;
+
+        cx_aes(&aesKey, CX_DECRYPT | CX_CHAIN_ECB | CX_PAD_NONE | CX_LAST,
+               cipher, AES_BLOCK_LENGTH, block);
+        for (uint32_t i = 0; i < AES_BLOCK_LENGTH; i++) {
+            block[i] ^= chain[i];
+        }
+        chain = cipher;
+
+        if (b == blocks - 1) {  // PKCS#7 padding: `pad` bytes, each of value `pad`
+            const uint8_t pad = block[AES_BLOCK_LENGTH - 1];
+            padded = (pad > 0 && pad <= AES_BLOCK_LENGTH);
+            for (uint32_t i = AES_BLOCK_LENGTH - pad; padded && i < AES_BLOCK_LENGTH - 1; i++) {
+                padded = (block[i] == pad);
+            }
+            length = padded ? AES_BLOCK_LENGTH - pad : 0;
+        }
+        while (plainLength < BTS_MEMO_CHECKSUM_LENGTH && start < length) {
+            checksum[plainLength++] = block[start++];
+        }
+        plainLength += length - start;
+        cx_hash(&sha256.header, 0, block + start, length - start, NULL);
+        appendBtsMemoText(buffer, bufferLength, &written, block + start, length - start);
+    }
+
+    // Digest of the text, into seed (the key is no longer needed):
+    cx_hash(&sha256.header, CX_LAST, NULL, 0, seed);
+    const bool valid = padded && plainLength >= BTS_MEMO_CHECKSUM_LENGTH
+                       && os_memcmp(seed, checksum, BTS_MEMO_CHECKSUM_LENGTH) == 0;
+
+    os_memset(seed, 0, sizeof(seed));
+    os_memset(&aesKey, 0, sizeof(aesKey));
+    os_memset(block, 0, sizeof(block));
+    if (!valid) {
+        buffer[0] = 0;
+    }
+    return valid;
+}
+
+/**
+ * Encrypts the whole block in tmpCtx.memoContext.block to `out`.
+ */
+static uint32_t encryptMemoBlock(uint8_t *out) {
+    memoContext_t *ctx = &tmpCtx.memoContext;
+    for (uint32_t i = 0; i < AES_BLOCK_LENGTH; i++) {
+        ctx->block[i] ^= ctx->chain[i];
+    }
+    cx_aes(&ctx->aesKey, CX_ENCRYPT | CX_CHAIN_ECB | CX_PAD_NONE | CX_LAST,
+           ctx->block, AES_BLOCK_LENGTH, ctx->chain);
+    os_memmove(out, ctx->chain, AES_BLOCK_LENGTH);
+    ctx->blockLength = 0;
+    return AES_BLOCK_LENGTH;
+}
+
+void memoEncryptBegin(const uint32_t *path, uint8_t pathLength,
+                      const bts_public_key_type_t *recipient, uint64_t nonce,
+                      const uint8_t *checksum, uint32_t textLength) {
+    memoContext_t *ctx = &tmpCtx.memoContext;
+    cx_ecfp_private_key_t privateKey;
+    bts_public_key_type_t ourKey;
+    uint8_t tag[16];
+    uint8_t sharedX[32];
+    uint8_t seed[64];
+    bool found;
+
+    memoEncryptAbort();
+    memoSecretTag(path, pathLength, recipient, tag);
+    found = findMemoSecret(tag, NULL, sharedX);
+    if (!found) {
+        deriveMemoKey(path, pathLength, &privateKey, &ourKey);
+        found = computeMemoSecret(&privateKey, &ourKey, recipient, tag, sharedX);
+        os_memset(&privateKey, 0, sizeof(privateKey));
+    }
+    if (!found) {
+        PRINTF("Invalid memo recipient key\n");
+        THROW(0x6A80);
+    }
+    memoCipherSeed(sharedX, nonce, seed);
+    os_memset(sharedX, 0, sizeof(sharedX));
+    os_memset(ctx, 0, sizeof(memoContext_t));
+    cx_aes_init_key(seed, 32, &ctx->aesKey);
+    os_memmove(ctx->chain, seed + 32, AES_BLOCK_LENGTH);
+    os_memset(seed, 0, sizeof(seed));
+    cx_sha256_init(&ctx->sha256);
+    os_memmove(ctx->checksum, checksum, BTS_MEMO_CHECKSUM_LENGTH);
+    os_memmove(ctx->block, checksum, BTS_MEMO_CHECKSUM_LENGTH);
+    ctx->blockLength = BTS_MEMO_CHECKSUM_LENGTH;
+    ctx->remaining = textLength;
+    encrypting = true;
+}
+
+uint32_t memoEncryptUpdate(const uint8_t *text, uint32_t length, uint8_t *out) {
+    memoContext_t *ctx = &tmpCtx.memoContext;
+    uint32_t written = 0;
+
+    if (!encrypting) {
+        PRINTF("No memo to encrypt\n");
+        THROW(0x6985);
+    }
+    if (length > MEMO_MAX_CHUNK) {
+        memoEncryptAbort();
+        THROW(0x6700);
+    }
+    if (length > ctx->remaining) {
+        PRINTF("Memo longer than promised\n");
+        memoEncryptAbort();
+        THROW(0x6A80);
+    }
+    cx_hash(&ctx->sha256.header, 0, text, length, NULL);
+    ctx->remaining -= length;
+    while (length > 0) {
+        const uint32_t take = MIN(length, AES_BLOCK_LENGTH - ctx->blockLength);
+        os_memmove(ctx->block + ctx->blockLength, text, take);
+        ctx->blockLength += take;
+        text += take;
+        length -= take;
+        if (ctx->blockLength == AES_BLOCK_LENGTH) {
+            written += encryptMemoBlock(out + written);
+        }
+    }
+
+    if (ctx->remaining == 0) {
+        uint8_t digest[32];
+        cx_hash(&ctx->sha256.header, CX_LAST, NULL, 0, digest);
+        if (os_memcmp(digest, ctx->checksum, BTS_MEMO_CHECKSUM_LENGTH) != 0) {
+            PRINTF("Memo checksum mismatch\n");
+            memoEncryptAbort();
+            THROW(0x6A80);
+        }
+        // PKCS#7 padding, a whole block of it if the text ended on a block:
+        const uint8_t pad = AES_BLOCK_LENGTH - ctx->blockLength;
+        os_memset(ctx->block + ctx->blockLength, pad, pad);
+        written += encryptMemoBlock(out + written);
+        memoEncryptAbort();
+    }
+    return written;
+}
+
+void memoEncryptAbort() {
+    if (encrypting) {
+        os_memset(&tmpCtx.memoContext, 0, sizeof(memoContext_t));
+        encrypting = false;
+    }
+}
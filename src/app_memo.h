@@ -0,0 +1,60 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __APP_MEMO_H__
+#define __APP_MEMO_H__
+
+#include "bts_t_memo.h"
+
+/**
+ * Most text the host may send per INS_ENCRYPT_MEMO APDU.  With up to 15 bytes
+ * already waiting for a whole block, and a block of padding at the end, the
+ * ciphertext returned for it never exceeds 240 bytes.
+ */
+#define MEMO_MAX_CHUNK 224
+
+/**
+ * Starts encrypting a memo of `textLength` bytes from the memo key at `path` to
+ * `recipient`, with the given nonce and checksum (the first four bytes of the
+ * SHA-256 of the text).  Throws 0x6A80 if `recipient` is not a valid key.
+ */
+void memoEncryptBegin(const uint32_t *path, uint8_t pathLength,
+                      const bts_public_key_type_t *recipient, uint64_t nonce,
+                      const uint8_t *checksum, uint32_t textLength);
+
+/**
+ * Encrypts the next `length` bytes of text, writing the ciphertext of each block
+ * completed to `out`, and returns the number of bytes written.  With the last of
+ * the text, checks the checksum and writes the padded final block.  `out` may
+ * overlap `text` if it starts at least 16 bytes before it.  Throws, and ends the
+ * memo, if there is more text than promised, or the checksum is wrong.
+ */
+uint32_t memoEncryptUpdate(const uint8_t *text, uint32_t length, uint8_t *out);
+
+/**
+ * Ends the memo being encrypted, if any, wiping its key.
+ */
+void memoEncryptAbort();
+
+/**
+ * Forgets the ECDH secrets cached for repeat memo counterparties.  Called when
+ * the app exits.
+ */
+void memoSecretCacheWipe();
+
+#endif
@@ -21,7 +21,9 @@
 
 #include "app_ui_displays.h"
 #include "app_ux.h"
+#include "bts_networks.h"
 #include "bts_stream.h"
+#include "bts_totals.h"
 #include "glyphs.h"
 
 #define WITH_SIZE(x) x, sizeof(x)
@@ -82,7 +84,7 @@ const bagl_element_t ui_approval_nanos[] = {
 
     {{BAGL_LABELINE, 0x02, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     "Tx ID",
+     (char *)ui_buffers.sign_tx.paramLabel,    /* Total n of m */
      0,
      0,
      0,
@@ -91,7 +93,7 @@ const bagl_element_t ui_approval_nanos[] = {
      NULL},
     {{BAGL_LABELINE, 0x02, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
-     (char *)ui_buffers.sign_tx.paramValue,
+     (char *)ui_buffers.sign_tx.paramValue,    /* Amount and symbol */
      0,
      0,
      0,
@@ -101,7 +103,7 @@ const bagl_element_t ui_approval_nanos[] = {
 
     {{BAGL_LABELINE, 0x03, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     (char *)ui_buffers.sign_tx.paramLabel,    /* Operation n of m */
+     "Tx ID",
      0,
      0,
      0,
@@ -109,6 +111,44 @@ const bagl_element_t ui_approval_nanos[] = {
      NULL,
      NULL},
     {{BAGL_LABELINE, 0x03, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
+     (char *)ui_buffers.sign_tx.paramValue,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x04, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Network",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x04, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
+     (char *)ui_buffers.sign_tx.paramValue,    /* Network name or fingerprint */
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x05, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)ui_buffers.sign_tx.paramLabel,    /* Operation n of m */
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x05, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 50},
      (char *)ui_buffers.sign_tx.paramValue,    /* Operation Name */
      0,
@@ -118,7 +158,7 @@ const bagl_element_t ui_approval_nanos[] = {
      NULL,
      NULL},
 
-    {{BAGL_LABELINE, 0x04, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x06, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
      (char *)ui_buffers.sign_tx.paramLabel,    /* Op Argument Label */
      0,
@@ -127,7 +167,7 @@ const bagl_element_t ui_approval_nanos[] = {
      NULL,
      NULL,
      NULL},
-    {{BAGL_LABELINE, 0x04, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x06, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
      (char *)ui_buffers.sign_tx.paramValue,    /* Op Argument Value */
      0,
@@ -143,7 +183,8 @@ const bagl_element_t *  ui_approval_prepro(const bagl_element_t *element)
     unsigned int display = 1;
     if (element->component.userid > 0)
     {
-        if (ux_step > 3 && element->component.userid == 4) {
+        if (ux_step > UX_STEP_SIGN_ARGUMENTS
+            && element->component.userid == UX_STEP_SIGN_ARGUMENTS + 1) {
             display = 1;
         } else {
             display = (ux_step == element->component.userid - 1);
@@ -159,6 +200,14 @@ const bagl_element_t *  ui_approval_prepro(const bagl_element_t *element)
 
                 break;
             case 2:
+                PRINTF("Totals\n");
+                UX_CALLBACK_SET_INTERVAL(MAX(
+                  3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
+
+                printTxTotals();
+
+                break;
+            case 3:
                 PRINTF("Transaction Id or Hash\n");
                 UX_CALLBACK_SET_INTERVAL(MAX(
                   3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
@@ -166,7 +215,15 @@ const bagl_element_t *  ui_approval_prepro(const bagl_element_t *element)
                 printTxId((char *)WITH_SIZE(ui_buffers.sign_tx.paramValue));
 
                 break;
-            case 3:
+            case 4:
+                PRINTF("Network\n");
+                UX_CALLBACK_SET_INTERVAL(MAX(
+                  3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
+
+                printNetwork((char *)WITH_SIZE(ui_buffers.sign_tx.paramValue));
+
+                break;
+            case 5:
                 PRINTF("Operation\n");
                 UX_CALLBACK_SET_INTERVAL(MAX(
                   3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
@@ -174,14 +231,14 @@ const bagl_element_t *  ui_approval_prepro(const bagl_element_t *element)
                  * updateOperationContent(). */
 
                 break;
-            case 4:
-                PRINTF("Argument: %d - (step: %d count %d)\n", ux_step - 3, ux_step, ux_step_count);
+            case 6:
+                PRINTF("Argument: %d - (step: %d count %d)\n", ux_step - UX_STEP_SIGN_ARGUMENTS, ux_step, ux_step_count);
                 PRINTF("  CurrentOpIdx: %d\n", txContent.currentOperation);
 
                 UX_CALLBACK_SET_INTERVAL(MAX(
                     3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
 
-                printTxOpArgument(ux_step - 3);
+                printTxOpArgument(ux_step - UX_STEP_SIGN_ARGUMENTS);
                 break;
             }
         }
@@ -17,6 +17,7 @@
 ********************************************************************************/
 
 #include "app_ui_menus.h"
+#include "app_memo.h"
 #include "app_nvm.h"
 #include "glyphs.h"
 
@@ -27,6 +28,7 @@ const ux_menu_entry_t menu_about[];
 
 void menu_settings_arbdata_entry(unsigned int ignored);  // Called in Settings menu
 void menu_settings_arbdata_change(unsigned int newval);  // ''
+void menu_quit(unsigned int ignored);                    // Called in Main menu
 
 /**
  *  MainMenu:
@@ -51,7 +53,7 @@ const ux_menu_entry_t menu_main[] = {
     {NULL, NULL, 0, &C_nanos_badge_bitshares, "Use wallet to", "view accounts", 33, 12},
     /*{menu_settings, NULL, 0, NULL, "Settings", NULL, 0, 0},*/ // Removed pending issue #20
     {menu_about, NULL, 0, NULL, "About", NULL, 0, 0},
-    {NULL, os_sched_exit, 0, &C_icon_dashboard, "Quit app", NULL, 50, 29},
+    {NULL, menu_quit, 0, &C_icon_dashboard, "Quit app", NULL, 50, 29},
     UX_MENU_END};
 
 const ux_menu_entry_t menu_settings[] = {
@@ -88,6 +90,16 @@ void menu_settings_arbdata_change(unsigned int newval) {
     UX_MENU_DISPLAY(0, menu_settings, NULL);  // Return to Settings menu
 }
 
+/**
+ * Called from Main->Quit.  Wipes what the session kept in RAM, and exits to
+ * the dashboard.
+*/
+void menu_quit(unsigned int ignored) {
+    UNUSED(ignored);
+    memoSecretCacheWipe();
+    os_sched_exit(0);
+}
+
 /**
  * Returns UI to top of main menu ("Use wallet to...").
 */
@@ -50,6 +50,16 @@ extern ux_state_t ux;
 extern unsigned int ux_step;        // For display stepped screens
 extern unsigned int ux_step_count;  //
 
+// Steps of the INS_SIGN review (ui_approval_nanos).  Each operation repeats
+// from UX_STEP_SIGN_OPERATION, with one step per argument after it.  The bagl
+// element userids for each step are the step number plus one.
+#define UX_STEP_SIGN_CONFIRM    0   // "Confirm Transaction"
+#define UX_STEP_SIGN_TOTALS     1   // Spent per asset, over all ops (has subscreens)
+#define UX_STEP_SIGN_TXID       2   // Tx ID
+#define UX_STEP_SIGN_NETWORK    3   // Chain the Tx is for
+#define UX_STEP_SIGN_OPERATION  4   // "Operation n of m" and its name
+#define UX_STEP_SIGN_ARGUMENTS  5   // First argument of the operation
+
 //
 // Instruction Service Routine (ISR) Contexts:
 //
@@ -57,9 +67,10 @@ extern unsigned int ux_step_count;  //
 // stream. Each payload codes an "Instruction".  We service the instruction,
 // and then go back to listening for the next instruction.  The instruction
 // codes are defined in main.c, but the only some are relevent here. These are
-// INS_GET_PUBLIC_KEY and INS_SIGN, as these are the ones that require context
-// variables, which we map out here and store in a union (since we only service
-// ONE instruction at a time, their contexts can overlap to save RAM).
+// INS_GET_PUBLIC_KEY, INS_SIGN and INS_ENCRYPT_MEMO, as these are the ones that
+// require context variables, which we map out here and store in a union (since
+// we only service ONE instruction at a time, their contexts can overlap to save
+// RAM).
 //
 
 typedef struct publicKeyContext_t {
@@ -74,12 +85,27 @@ typedef struct publicKeyContext_t {
 typedef struct transactionContext_t {
     uint8_t pathLength;
     uint32_t bip32Path[MAX_BIP32_PATH];
+    uint8_t memoPathLength;   // Zero if the host gave no memo key (see app_memo.c)
+    uint32_t memoPath[MAX_BIP32_PATH];
     uint8_t hash[32];         // Message hash for which we will provide signature.
 } transactionContext_t;
 
+#define AES_BLOCK_LENGTH 16
+
+typedef struct memoContext_t {
+    cx_aes_key_t aesKey;
+    cx_sha256_t sha256;                 // Of the text so far
+    uint8_t chain[AES_BLOCK_LENGTH];    // Last cipher block, or the IV
+    uint8_t block[AES_BLOCK_LENGTH];    // Plaintext short of a whole block
+    uint8_t blockLength;
+    uint8_t checksum[4];                // As the host gave it
+    uint32_t remaining;                 // Text bytes yet to come
+} memoContext_t;
+
 union ISRContext_u {
     publicKeyContext_t publicKeyContext;
     transactionContext_t transactionContext;
+    memoContext_t memoContext;
 };
 
 extern union ISRContext_u tmpCtx;
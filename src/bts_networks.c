@@ -0,0 +1,74 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "bts_networks.h"
+#include "eos_utils.h"
+#include "os.h"
+
+/**
+ * Known chains.  At most eight entries (one bit each in networkMatch_t).  The
+ * index of an entry is what is stored in txContent.network, so append only.
+ */
+static const networkInfo_t networks[] = {
+    {"BitShares", {0x40, 0x18, 0xd7, 0x84, 0x4c, 0x78, 0xf6, 0xa6, 0xc4, 0x1c, 0x6a, 0x55, 0x2b, 0x89, 0x80, 0x22,
+                   0x31, 0x0f, 0xc5, 0xde, 0xc0, 0x6d, 0xa4, 0x67, 0xee, 0x79, 0x05, 0xa8, 0xda, 0xd5, 0x12, 0xc8}},
+    {"BTS Testnet", {0x39, 0xf5, 0xe2, 0xed, 0xe1, 0xf8, 0xbc, 0x1a, 0x3a, 0x54, 0xa7, 0x91, 0x44, 0x14, 0xe3, 0x77,
+                     0x9e, 0x33, 0x19, 0x3f, 0x1f, 0x56, 0x93, 0x51, 0x0e, 0x73, 0xcb, 0x7a, 0x87, 0x61, 0x74, 0x47}},
+};
+#define NUM_NETWORKS (sizeof(networks) / sizeof(networks[0]))
+
+networkMatch_t networkMatchBegin() {
+    return (networkMatch_t)((1u << NUM_NETWORKS) - 1);
+}
+
+networkMatch_t networkMatchUpdate(networkMatch_t candidates, uint32_t offset,
+                                  const uint8_t *chunk, uint32_t length) {
+    if (offset > CHAIN_ID_LENGTH || length > CHAIN_ID_LENGTH - offset) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < NUM_NETWORKS; i++) {
+        if ((candidates & (1u << i)) != 0) {
+            const networkInfo_t *network = (const networkInfo_t *)PIC(&networks[i]);
+            if (os_memcmp(network->chainId + offset, chunk, length) != 0) {
+                candidates &= ~(1u << i);
+            }
+        }
+    }
+    return candidates;
+}
+
+uint8_t networkMatchResult(networkMatch_t candidates) {
+    for (uint8_t i = 0; i < NUM_NETWORKS; i++) {
+        if ((candidates & (1u << i)) != 0) {
+            return i;
+        }
+    }
+    return NETWORK_UNKNOWN;
+}
+
+void printNetwork(char *dispbuffer, size_t length) {
+    if (txContent.network < NUM_NETWORKS) {
+        const networkInfo_t *network = (const networkInfo_t *)PIC(&networks[txContent.network]);
+        snprintf(dispbuffer, length, "%s", (const char *)PIC(network->name));
+        return;
+    }
+    char fingerprint[2 * sizeof(txContent.chainIdFingerprint) + 1];
+    os_memset(fingerprint, 0, sizeof(fingerprint));
+    array_hexstr(fingerprint, txContent.chainIdFingerprint, sizeof(txContent.chainIdFingerprint));
+    snprintf(dispbuffer, length, "Unknown %s...", fingerprint);
+}
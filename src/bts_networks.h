@@ -0,0 +1,62 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __BTS_NETWORKS_H__
+#define __BTS_NETWORKS_H__
+
+#include "bts_stream.h"
+
+/**
+ * Chains we know by name.  The ChainID that prefixes every transaction is
+ * matched against this table as its bytes stream past (see
+ * processChainIdField()), keeping a bitmask of the entries that still match,
+ * so recognition costs no second pass and no copy of the ChainID.
+ */
+typedef struct networkInfo_t {
+    const char *name;
+    uint8_t chainId[CHAIN_ID_LENGTH];
+} networkInfo_t;
+
+#define NETWORK_UNKNOWN 0xFF        // txContent.network if no entry matched
+
+typedef uint8_t networkMatch_t;     // One bit per table entry still matching
+
+/**
+ * Starts a match: every entry is a candidate.
+ */
+networkMatch_t networkMatchBegin();
+
+/**
+ * Drops the candidates that differ from `length` bytes of ChainID at `offset`.
+ */
+networkMatch_t networkMatchUpdate(networkMatch_t candidates, uint32_t offset,
+                                  const uint8_t *chunk, uint32_t length);
+
+/**
+ * Index of the entry matched, once the whole ChainID has been seen, or
+ * NETWORK_UNKNOWN.
+ */
+uint8_t networkMatchResult(networkMatch_t candidates);
+
+/**
+ * Prints the name of the network txContent.network, or for an unknown chain
+ * a fingerprint from the leading bytes of its ChainID.
+ */
+void printNetwork(char *dispbuffer, size_t length);
+
+#endif
@@ -16,71 +16,40 @@
 *  limitations under the License.
 ********************************************************************************/
 
+#include "bts_op_config.h"
+
+#ifdef HAVE_OP_ACCOUNT_UPDATE
+
 #include "bts_op_account_update.h"
 #include "bts_types.h"
 #include "os.h"
 
-uint32_t deserializeBtsOperationAccountUpdate(const uint8_t *buffer, uint32_t bufferLength, bts_operation_account_update_t * op) {
-
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
-
-    gobbled = deserializeBtsAssetType(buffer, bufferLength, &op->feeAsset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsAccountIdType(buffer, bufferLength, &op->accountId);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+btsDeserialStatus_e deserializeBtsOperationAccountUpdate(bts_cursor_t *cursor, bts_operation_account_update_t * op) {
 
-    gobbled = deserializeBtsBoolType(buffer, bufferLength, &op->ownerPermissionPresent);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsAssetType(cursor, &op->feeAsset);
+    deserializeBtsAccountIdType(cursor, &op->accountId);
+    deserializeBtsBoolType(cursor, &op->ownerPermissionPresent);
 
-    if (op->ownerPermissionPresent) {
-        gobbled = deserializeBtsPermissionType(buffer, bufferLength, &op->ownerPermission);
-        if (gobbled > bufferLength) {
-            THROW(EXCEPTION);
-        }
-        read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    if (cursor->error == DESERIAL_OK && op->ownerPermissionPresent) {
+        deserializeBtsPermissionType(cursor, &op->ownerPermission);
     }
 
-    gobbled = deserializeBtsBoolType(buffer, bufferLength, &op->activePermissionPresent);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsBoolType(cursor, &op->activePermissionPresent);
 
-    if (op->activePermissionPresent) {
-        gobbled = deserializeBtsPermissionType(buffer, bufferLength, &op->activePermission);
-        if (gobbled > bufferLength) {
-            THROW(EXCEPTION);
-        }
-        read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    if (cursor->error == DESERIAL_OK && op->activePermissionPresent) {
+        deserializeBtsPermissionType(cursor, &op->activePermission);
     }
 
-    gobbled = deserializeBtsBoolType(buffer, bufferLength, &op->accountOptionsPresent);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsBoolType(cursor, &op->accountOptionsPresent);
 
     // We will have "uninterpretable" data if *either* the included AccountOptions
     // object *or* the operation as a whole has extensions.
     op->containsUninterpretable = false;
-    if (op->accountOptionsPresent) {
-        gobbled = deserializeBtsAccountOptionsType(buffer, bufferLength, &op->accountOptions);
-        if (gobbled > bufferLength) {
-            THROW(EXCEPTION);
-        }
-        read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-        if (op->accountOptions.extensions.count > 0) {
+    op->extensions.count = 0;
+
+    if (cursor->error == DESERIAL_OK && op->accountOptionsPresent) {
+        deserializeBtsAccountOptionsType(cursor, &op->accountOptions);
+        if (cursor->error == DESERIAL_OK && op->accountOptions.extensions.count > 0) {
             op->containsUninterpretable = true;
         }
     }
@@ -88,23 +57,21 @@ uint32_t deserializeBtsOperationAccountUpdate(const uint8_t *buffer, uint32_t bu
     if (!op->containsUninterpretable) {
         // Only decode Op-level extensions if there are NOT AccountOptions-level extensions.
         // (Because otherwise we are not aligned on the Op-level extensions.)
-        gobbled = deserializeBtsExtensionArrayType(buffer, bufferLength, &op->extensions);
-        if (gobbled > bufferLength) {
-            THROW(EXCEPTION);
-        }
-        read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-    }   // Else op->extensions is uninitialized, but it doesn't matter because we've already
+        deserializeBtsExtensionArrayType(cursor, &op->extensions);
+    }   // Else op->extensions is left at zero, but it doesn't matter because we've already
         // flagged presence of uninterpretable data.  Obvs, this will need to become more
         // sophistcated if we later implement support for AccountOptions-level extensions.
 
     if (op->containsUninterpretable || op->extensions.count > 0) {
-        op->containsUninterpretable = true;  // (Not worried about false pos on op->exts.count,
-    } else {                                 // since this could only happen if containsUnint
-        op->containsUninterpretable = false; // is already true.)
+        op->containsUninterpretable = true;
+    } else {
+        op->containsUninterpretable = false;
     }
 
-    PRINTF("DESERIAL: OP_ACCOUNT_UPDATE: Read %d bytes; Buffer remaining: %d bytes\n", read, bufferLength);
+    PRINTF("DESERIAL: OP_ACCOUNT_UPDATE: Status %d; Buffer remaining: %d bytes\n", cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
+
+#endif
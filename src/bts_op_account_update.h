@@ -39,6 +39,6 @@ typedef struct bts_operation_account_update_t {
     bool containsUninterpretable;
 } bts_operation_account_update_t;
 
-uint32_t deserializeBtsOperationAccountUpdate(const uint8_t *buffer, uint32_t bufferLength, bts_operation_account_update_t * op);
+btsDeserialStatus_e deserializeBtsOperationAccountUpdate(bts_cursor_t *cursor, bts_operation_account_update_t * op);
 
 #endif
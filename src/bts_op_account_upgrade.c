@@ -16,38 +16,20 @@
 *  limitations under the License.
 ********************************************************************************/
 
+#include "bts_op_config.h"
+
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
+
 #include "bts_op_account_upgrade.h"
 #include "bts_types.h"
 #include "os.h"
 
-uint32_t deserializeBtsOperationAccountUpgrade(const uint8_t *buffer, uint32_t bufferLength, bts_operation_account_upgrade_t * op) {
-
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+btsDeserialStatus_e deserializeBtsOperationAccountUpgrade(bts_cursor_t *cursor, bts_operation_account_upgrade_t * op) {
 
-    gobbled = deserializeBtsAssetType(buffer, bufferLength, &op->feeAsset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsAccountIdType(buffer, bufferLength, &op->accountId);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsBoolType(buffer, bufferLength, &op->upgradeLtm);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsExtensionArrayType(buffer, bufferLength, &op->extensions);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsAssetType(cursor, &op->feeAsset);
+    deserializeBtsAccountIdType(cursor, &op->accountId);
+    deserializeBtsBoolType(cursor, &op->upgradeLtm);
+    deserializeBtsExtensionArrayType(cursor, &op->extensions);
 
     if (op->extensions.count > 0) {
       op->containsUninterpretable = true;
@@ -55,8 +37,10 @@ uint32_t deserializeBtsOperationAccountUpgrade(const uint8_t *buffer, uint32_t b
       op->containsUninterpretable = false;
     }
 
-    PRINTF("DESERIAL: OP_LIMIT_CREATE: Read %d bytes; Buffer remaining: %d bytes\n", read, bufferLength);
+    PRINTF("DESERIAL: OP_ACCOUNT_UPGRADE: Status %d; Buffer remaining: %d bytes\n", cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
+
+#endif
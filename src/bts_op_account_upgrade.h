@@ -33,6 +33,6 @@ typedef struct bts_operation_account_upgrade_t {
     bool containsUninterpretable;
 } bts_operation_account_upgrade_t;
 
-uint32_t deserializeBtsOperationAccountUpgrade(const uint8_t *buffer, uint32_t bufferLength, bts_operation_account_upgrade_t * op);
+btsDeserialStatus_e deserializeBtsOperationAccountUpgrade(bts_cursor_t *cursor, bts_operation_account_upgrade_t * op);
 
 #endif
@@ -0,0 +1,47 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "bts_op_config.h"
+
+#ifdef HAVE_OP_BID_COLLATERAL
+
+#include "bts_op_bid_collateral.h"
+#include "bts_types.h"
+#include "os.h"
+
+btsDeserialStatus_e deserializeBtsOperationBidCollateral(bts_cursor_t *cursor, bts_operation_bid_collateral_t * op) {
+
+    deserializeBtsAssetType(cursor, &op->feeAsset);
+    deserializeBtsAccountIdType(cursor, &op->bidder);
+    deserializeBtsAssetType(cursor, &op->additionalCollateral);
+    deserializeBtsAssetType(cursor, &op->debtCovered);
+    deserializeBtsExtensionArrayType(cursor, &op->extensions);
+
+    if (op->extensions.count > 0) {
+      op->containsUninterpretable = true;
+    } else {
+      op->containsUninterpretable = false;
+    }
+
+    PRINTF("DESERIAL: OP_BID_COLLATERAL: Status %d; Buffer remaining: %d bytes\n", cursor->error, cursor->remaining);
+
+    return cursor->error;
+
+}
+
+#endif
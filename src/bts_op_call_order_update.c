@@ -0,0 +1,72 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "bts_op_config.h"
+
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+
+#include "bts_op_call_order_update.h"
+#include "bts_types.h"
+#include "os.h"
+
+/**
+ * The extensions of call_order_update are a graphene extension<> struct, not the
+ * usual empty set: a count of fields present, then for each its index and value.
+ * Index 0 is target_collateral_ratio, an optional uint16.  Any other index is
+ * newer than us, and since we can't know its length or show it, we fail with
+ * DESERIAL_UNSUPPORTED, and the transaction is refused.
+ */
+static void deserializeCallOrderExtensions(bts_cursor_t *cursor, bts_operation_call_order_update_t * op) {
+
+    bts_varint32_type_t count = 0;
+    bts_varint32_type_t index;
+    uint32_t i;
+
+    op->targetCRPresent = false;
+    op->targetCR = 0;
+
+    deserializeBtsVarint32Type(cursor, &count);
+    for (i = 0; i < count && cursor->error == DESERIAL_OK; i++) {
+        deserializeBtsVarint32Type(cursor, &index);
+        if (cursor->error != DESERIAL_OK) {
+            break;
+        }
+        if (index == 0 && !op->targetCRPresent) {
+            cursorReadBytes(cursor, &op->targetCR, sizeof(uint16_t));
+            op->targetCRPresent = true;
+        } else {
+            cursorFail(cursor, DESERIAL_UNSUPPORTED);
+        }
+    }
+}
+
+btsDeserialStatus_e deserializeBtsOperationCallOrderUpdate(bts_cursor_t *cursor, bts_operation_call_order_update_t * op) {
+
+    deserializeBtsAssetType(cursor, &op->feeAsset);
+    deserializeBtsAccountIdType(cursor, &op->fundingAccount);
+    deserializeBtsAssetType(cursor, &op->deltaCollateral);
+    deserializeBtsAssetType(cursor, &op->deltaDebt);
+    deserializeCallOrderExtensions(cursor, op);
+
+    PRINTF("DESERIAL: OP_CALL_ORDER_UPDATE: Status %d; Buffer remaining: %d bytes\n", cursor->error, cursor->remaining);
+
+    return cursor->error;
+
+}
+
+#endif
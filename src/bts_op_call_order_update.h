@@ -0,0 +1,38 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __BTS_OP_CALL_ORDER_UPDATE_H__
+#define __BTS_OP_CALL_ORDER_UPDATE_H__
+
+#include "bts_t_asset.h"
+#include "bts_t_account.h"
+#include "bts_t_varint.h"
+#include <stdbool.h>
+
+typedef struct bts_operation_call_order_update_t {
+    bts_asset_type_t feeAsset;
+    bts_account_id_type_t fundingAccount;
+    bts_asset_type_t deltaCollateral;   // Signed amounts: collateral added (+)
+    bts_asset_type_t deltaDebt;         // or released (-), debt borrowed (+) or repaid (-)
+    bool targetCRPresent;
+    uint16_t targetCR;                  // Target collateral ratio, in thousandths
+} bts_operation_call_order_update_t;
+
+btsDeserialStatus_e deserializeBtsOperationCallOrderUpdate(bts_cursor_t *cursor, bts_operation_call_order_update_t * op);
+
+#endif
@@ -0,0 +1,52 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __BTS_OP_CONFIG_H__
+#define __BTS_OP_CONFIG_H__
+
+/**
+ * Build-time operation selection.  Each HAVE_OP_* compiles in the deserializer
+ * and display parser for one operation; operations left out are still named in
+ * the registry, and shown and signed as "Unsupported", as for any operation the
+ * app can't display.
+ *
+ * The Makefile's OPS= list (e.g. `make OPS=transfer,limit_order`) defines
+ * BTS_OPS_SELECTED and the chosen HAVE_OP_* flags.  Without it, e.g. in the host
+ * build, every displayable operation is compiled in.
+ */
+#ifndef BTS_OPS_SELECTED
+#define HAVE_OP_TRANSFER
+#define HAVE_OP_LIMIT_ORDER_CREATE
+#define HAVE_OP_LIMIT_ORDER_CANCEL
+#define HAVE_OP_CALL_ORDER_UPDATE
+#define HAVE_OP_ACCOUNT_UPDATE
+#define HAVE_OP_ACCOUNT_UPGRADE
+#define HAVE_OP_PROPOSAL_CREATE
+#define HAVE_OP_BID_COLLATERAL
+#endif
+
+/* Defined if any operation at all is built in.  Helpers that every operation
+ * uses, such as for totals, are built only then. */
+#if defined(HAVE_OP_TRANSFER) || defined(HAVE_OP_LIMIT_ORDER_CREATE) \
+    || defined(HAVE_OP_LIMIT_ORDER_CANCEL) || defined(HAVE_OP_CALL_ORDER_UPDATE) \
+    || defined(HAVE_OP_ACCOUNT_UPDATE) || defined(HAVE_OP_ACCOUNT_UPGRADE) \
+    || defined(HAVE_OP_PROPOSAL_CREATE) || defined(HAVE_OP_BID_COLLATERAL)
+#define HAVE_OP_ANY
+#endif
+
+#endif
@@ -33,6 +33,6 @@ typedef struct bts_operation_limit_order_cancel_t {
     bool containsUninterpretable;
 } bts_operation_limit_order_cancel_t;
 
-uint32_t deserializeBtsOperationLimitOrderCancel(const uint8_t *buffer, uint32_t bufferLength, bts_operation_limit_order_cancel_t * op);
+btsDeserialStatus_e deserializeBtsOperationLimitOrderCancel(bts_cursor_t *cursor, bts_operation_limit_order_cancel_t * op);
 
 #endif
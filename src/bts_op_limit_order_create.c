@@ -16,56 +16,23 @@
 *  limitations under the License.
 ********************************************************************************/
 
+#include "bts_op_config.h"
+
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
+
 #include "bts_op_limit_order_create.h"
 #include "bts_types.h"
 #include "os.h"
 
-uint32_t deserializeBtsOperationLimitOrderCreate(const uint8_t *buffer, uint32_t bufferLength, bts_operation_limit_order_create_t * op) {
+btsDeserialStatus_e deserializeBtsOperationLimitOrderCreate(bts_cursor_t *cursor, bts_operation_limit_order_create_t * op) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
-
-    gobbled = deserializeBtsAssetType(buffer, bufferLength, &op->feeAsset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsAccountIdType(buffer, bufferLength, &op->sellerId);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsAssetType(buffer, bufferLength, &op->sellAsset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsAssetType(buffer, bufferLength, &op->buyAsset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsTimeType(buffer, bufferLength, &op->expires);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsBoolType(buffer, bufferLength, &op->fillOrKill);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsExtensionArrayType(buffer, bufferLength, &op->extensions);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsAssetType(cursor, &op->feeAsset);
+    deserializeBtsAccountIdType(cursor, &op->sellerId);
+    deserializeBtsAssetType(cursor, &op->sellAsset);
+    deserializeBtsAssetType(cursor, &op->buyAsset);
+    deserializeBtsTimeType(cursor, &op->expires);
+    deserializeBtsBoolType(cursor, &op->fillOrKill);
+    deserializeBtsExtensionArrayType(cursor, &op->extensions);
 
     if (op->extensions.count > 0) {
       op->containsUninterpretable = true;
@@ -73,8 +40,10 @@ uint32_t deserializeBtsOperationLimitOrderCreate(const uint8_t *buffer, uint32_t
       op->containsUninterpretable = false;
     }
 
-    PRINTF("DESERIAL: OP_LIMIT_CREATE: Read %d bytes; Buffer remaining: %d bytes\n", read, bufferLength);
+    PRINTF("DESERIAL: OP_LIMIT_CREATE: Status %d; Buffer remaining: %d bytes\n", cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
+
+#endif
@@ -36,6 +36,6 @@ typedef struct bts_operation_limit_order_create_t {
     bool containsUninterpretable;
 } bts_operation_limit_order_create_t;
 
-uint32_t deserializeBtsOperationLimitOrderCreate(const uint8_t *buffer, uint32_t bufferLength, bts_operation_limit_order_create_t * op);
+btsDeserialStatus_e deserializeBtsOperationLimitOrderCreate(bts_cursor_t *cursor, bts_operation_limit_order_create_t * op);
 
 #endif
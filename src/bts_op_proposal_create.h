@@ -0,0 +1,50 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __BTS_OP_PROPOSAL_CREATE_H__
+#define __BTS_OP_PROPOSAL_CREATE_H__
+
+#include "bts_t_asset.h"
+#include "bts_t_account.h"
+#include "bts_t_time.h"
+#include "bts_t_bool.h"
+#include "bts_t_varint.h"
+#include "bts_t_extensions.h"
+#include <stdbool.h>
+
+/**
+ * A proposal_create as cached in operationDataBuffer: every field of the
+ * serialized operation except the proposed operations themselves, which the
+ * stream caches (or elides) as operations in their own right.  Only their
+ * count is kept here.  See TLV_OP_COMPLEX in bts_stream.h.
+ */
+typedef struct bts_operation_proposal_create_t {
+    bts_asset_type_t feeAsset;
+    bts_account_id_type_t feePayingAccount;
+    bts_time_type_t expirationTime;
+    bts_varint32_type_t proposedOpsCount;
+    const uint8_t * pProposedOpsCount;  // Points to the count in OpData buffer
+    bts_bool_type_t reviewPeriodPresent;
+    uint32_t reviewPeriodSeconds;
+    bts_extension_array_type_t extensions;
+    bool containsUninterpretable;
+} bts_operation_proposal_create_t;
+
+btsDeserialStatus_e deserializeBtsOperationProposalCreate(bts_cursor_t *cursor, bts_operation_proposal_create_t * op);
+
+#endif
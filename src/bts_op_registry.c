@@ -0,0 +1,188 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "bts_op_registry.h"
+#include "bts_parse_operations.h"
+#include "os.h"
+
+/**
+ * Adapters from the typed deserializers to the registry prototype.
+ */
+#ifdef HAVE_OP_TRANSFER
+static btsDeserialStatus_e deserializeTransfer(bts_cursor_t *cursor, bts_operation_u *op) {
+    return deserializeBtsOperationTransfer(cursor, &op->transfer);
+}
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
+static btsDeserialStatus_e deserializeLimitOrderCreate(bts_cursor_t *cursor, bts_operation_u *op) {
+    return deserializeBtsOperationLimitOrderCreate(cursor, &op->limitOrderCreate);
+}
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CANCEL
+static btsDeserialStatus_e deserializeLimitOrderCancel(bts_cursor_t *cursor, bts_operation_u *op) {
+    return deserializeBtsOperationLimitOrderCancel(cursor, &op->limitOrderCancel);
+}
+#endif
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+static btsDeserialStatus_e deserializeCallOrderUpdate(bts_cursor_t *cursor, bts_operation_u *op) {
+    return deserializeBtsOperationCallOrderUpdate(cursor, &op->callOrderUpdate);
+}
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPDATE
+static btsDeserialStatus_e deserializeAccountUpdate(bts_cursor_t *cursor, bts_operation_u *op) {
+    return deserializeBtsOperationAccountUpdate(cursor, &op->accountUpdate);
+}
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
+static btsDeserialStatus_e deserializeAccountUpgrade(bts_cursor_t *cursor, bts_operation_u *op) {
+    return deserializeBtsOperationAccountUpgrade(cursor, &op->accountUpgrade);
+}
+#endif
+#ifdef HAVE_OP_PROPOSAL_CREATE
+static btsDeserialStatus_e deserializeProposalCreate(bts_cursor_t *cursor, bts_operation_u *op) {
+    return deserializeBtsOperationProposalCreate(cursor, &op->proposalCreate);
+}
+#endif
+#ifdef HAVE_OP_BID_COLLATERAL
+static btsDeserialStatus_e deserializeBidCollateral(bts_cursor_t *cursor, bts_operation_u *op) {
+    return deserializeBtsOperationBidCollateral(cursor, &op->bidCollateral);
+}
+#endif
+
+#define SUPPORTED_OP(name, parser, deserializer, argc) \
+    { name, parser, deserializer, TLV_OP_SIMPLE, argc }
+#define UNSUPPORTED_OP(name) \
+    { name, parseUnsupportedOperation, NULL, TLV_OP_UNSUPPORTED, 2 }
+/* Ops holding a list of ops.  The host splits these into several fields (see
+ * TLV_OP_COMPLEX), so they stream as complex even when not built in; then only
+ * the proposed ops are cached and the op itself is shown as unsupported. */
+#define COMPLEX_OP(name, parser, deserializer, argc) \
+    { name, parser, deserializer, TLV_OP_COMPLEX, argc }
+#define UNSUPPORTED_COMPLEX_OP(name) \
+    { name, parseUnsupportedOperation, NULL, TLV_OP_COMPLEX, 2 }
+
+/**
+ * Global Resource: The Operation Registry, indexed by the operationId enum in
+ * bts_stream.h.  E.g. op_registry[OP_TRANSFER].name should resolve to a pointer
+ * to "Transfer".  Remember that the pointers in here need PIC() before deref.
+ */
+static const operationInfo_t op_registry[OP_NUM_KNOWN_OPS] = {
+#ifdef HAVE_OP_TRANSFER
+    [OP_TRANSFER]                   = SUPPORTED_OP("Transfer", parseTransferOperation,
+                                                   deserializeTransfer, 5),
+#else
+    [OP_TRANSFER]                   = UNSUPPORTED_OP("Transfer"),
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
+    [OP_LIMIT_ORDER_CREATE]         = SUPPORTED_OP("Limit Order", parseLimitOrderCreateOperation,
+                                                   deserializeLimitOrderCreate, 6),
+#else
+    [OP_LIMIT_ORDER_CREATE]         = UNSUPPORTED_OP("Limit Order"),
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CANCEL
+    [OP_LIMIT_ORDER_CANCEL]         = SUPPORTED_OP("Cancel Order", parseLimitOrderCancelOperation,
+                                                   deserializeLimitOrderCancel, 3),
+#else
+    [OP_LIMIT_ORDER_CANCEL]         = UNSUPPORTED_OP("Cancel Order"),
+#endif
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+    [OP_CALL_ORDER_UPDATE]          = SUPPORTED_OP("Adjust Collateral", parseCallOrderUpdateOperation,
+                                                   deserializeCallOrderUpdate, 5),
+#else
+    [OP_CALL_ORDER_UPDATE]          = UNSUPPORTED_OP("Adjust Collateral"),
+#endif
+    [OP_FILL_ORDER]                 = UNSUPPORTED_OP("fill_order"), /* virtual */
+    [OP_ACCOUNT_CREATE]             = UNSUPPORTED_OP("Register Account"),
+#ifdef HAVE_OP_ACCOUNT_UPDATE
+    [OP_ACCOUNT_UPDATE]             = SUPPORTED_OP("Update Acct", parseAccountUpdateOperation,
+                                                   deserializeAccountUpdate, 5),
+#else
+    [OP_ACCOUNT_UPDATE]             = UNSUPPORTED_OP("Update Acct"),
+#endif
+    [OP_ACCOUNT_WHITELIST]          = UNSUPPORTED_OP("Whitelist Account"),
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
+    [OP_ACCOUNT_UPGRADE]            = SUPPORTED_OP("Upgrade Acct", parseAccountUpgradeOperation,
+                                                   deserializeAccountUpgrade, 3),
+#else
+    [OP_ACCOUNT_UPGRADE]            = UNSUPPORTED_OP("Upgrade Acct"),
+#endif
+    [OP_ACCOUNT_TRANSFER]           = UNSUPPORTED_OP("Transfer Account Ownership"),
+    [OP_ASSET_CREATE]               = UNSUPPORTED_OP("Create Asset"),
+    [OP_ASSET_UPDATE]               = UNSUPPORTED_OP("asset_update"),
+    [OP_ASSET_UPDATE_BITASSET]      = UNSUPPORTED_OP("asset_update_bitasset"),
+    [OP_ASSET_UPDATE_FEED_PRODUCERS]= UNSUPPORTED_OP("asset_update_feed_producers"),
+    [OP_ASSET_ISSUE]                = UNSUPPORTED_OP("asset_issue"),
+    [OP_ASSET_RESERVE]              = UNSUPPORTED_OP("asset_reserve"),
+    [OP_ASSET_FUND_FEE_POOL]        = UNSUPPORTED_OP("asset_fund_fee_pool"),
+    [OP_ASSET_SETTLE]               = UNSUPPORTED_OP("asset_settle"),
+    [OP_ASSET_GLOBAL_SETTLE]        = UNSUPPORTED_OP("asset_global_settle"),
+    [OP_ASSET_PUBLISH_FEED]         = UNSUPPORTED_OP("asset_publish_feed"),
+    [OP_WITNESS_CREATE]             = UNSUPPORTED_OP("witness_create"),
+    [OP_WITNESS_UPDATE]             = UNSUPPORTED_OP("witness_update"),
+#ifdef HAVE_OP_PROPOSAL_CREATE
+    [OP_PROPOSAL_CREATE]            = COMPLEX_OP("Proposal", parseProposalCreateOperation,
+                                                 deserializeProposalCreate, 5),
+#else
+    [OP_PROPOSAL_CREATE]            = UNSUPPORTED_COMPLEX_OP("Proposal"),
+#endif
+    [OP_PROPOSAL_UPDATE]            = UNSUPPORTED_OP("proposal_update"),
+    [OP_PROPOSAL_DELETE]            = UNSUPPORTED_OP("proposal_delete"),
+    [OP_WITHDRAW_PERMISSION_CREATE] = UNSUPPORTED_OP("withdraw_permission_create"),
+    [OP_WITHDRAW_PERMISSION_UPDATE] = UNSUPPORTED_OP("withdraw_permission_update"),
+    [OP_WITHDRAW_PERMISSION_CLAIM]  = UNSUPPORTED_OP("withdraw_permission_claim"),
+    [OP_WITHDRAW_PERMISSION_DELETE] = UNSUPPORTED_OP("withdraw_permission_delete"),
+    [OP_COMMITTEE_MEMBER_CREATE]    = UNSUPPORTED_OP("committee_member_create"),
+    [OP_COMMITTEE_MEMBER_UPDATE]    = UNSUPPORTED_OP("committee_member_update"),
+    [OP_COMMITTEE_MEMBER_UPDATE_GLOBAL_PARAMETERS]
+                                    = UNSUPPORTED_OP("committee_member_update_global_parameters"),
+    [OP_VESTING_BALANCE_CREATE]     = UNSUPPORTED_OP("vesting_balance_create"),
+    [OP_VESTING_BALANCE_WITHDRAW]   = UNSUPPORTED_OP("vesting_balance_withdraw"),
+    [OP_WORKER_CREATE]              = UNSUPPORTED_OP("worker_create"),
+    [OP_CUSTOM]                     = UNSUPPORTED_OP("custom"),
+    [OP_ASSERT]                     = UNSUPPORTED_OP("assert"),
+    [OP_BALANCE_CLAIM]              = UNSUPPORTED_OP("balance_claim"),
+    [OP_OVERRIDE_TRANSFER]          = UNSUPPORTED_OP("override_transfer"),
+    [OP_TRANSFER_TO_BLIND]          = UNSUPPORTED_OP("transfer_to_blind"),
+    [OP_BLIND_TRANSFER]             = UNSUPPORTED_OP("blind_transfer"),
+    [OP_TRANSFER_FROM_BLIND]        = UNSUPPORTED_OP("transfer_from_blind"),
+    [OP_ASSET_SETTLE_CANCEL]        = UNSUPPORTED_OP("asset_settle_cancel"), /* virtual */
+    [OP_ASSET_CLAIM_FEES]           = UNSUPPORTED_OP("asset_claim_fees"),
+    [OP_FBA_DISTRIBUTE]             = UNSUPPORTED_OP("fba_distribute"),      /* virtual */
+#ifdef HAVE_OP_BID_COLLATERAL
+    [OP_BID_COLLATERAL]             = SUPPORTED_OP("Bid Collateral", parseBidCollateralOperation,
+                                                   deserializeBidCollateral, 4),
+#else
+    [OP_BID_COLLATERAL]             = UNSUPPORTED_OP("Bid Collateral"),
+#endif
+    [OP_EXECUTE_BID]                = UNSUPPORTED_OP("execute_bid"),         /* virtual */
+    [OP_ASSET_CLAIM_POOL]           = UNSUPPORTED_OP("asset_claim_pool"),
+    [OP_ASSET_UPDATE_ISSUER]        = UNSUPPORTED_OP("asset_update_issuer"),
+};
+
+/**
+ * For operations that we just haven't a clue about.
+ */
+static const operationInfo_t op_unknown =
+    { "** Unknown Operation **", parseUnknownOperation, NULL, TLV_OP_UNSUPPORTED, 2 };
+
+const operationInfo_t * getOperationInfo(operationId_t opId) {
+    if (opId < OP_NUM_KNOWN_OPS) {
+        return &op_registry[opId];
+    }
+    return &op_unknown;
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __BTS_OP_REGISTRY_H__
+#define __BTS_OP_REGISTRY_H__
+
+#include <stdbool.h>
+#include "bts_stream.h"
+#include "bts_op_config.h"
+#ifdef HAVE_OP_TRANSFER
+#include "bts_op_transfer.h"
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
+#include "bts_op_limit_order_create.h"
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CANCEL
+#include "bts_op_limit_order_cancel.h"
+#endif
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+#include "bts_op_call_order_update.h"
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPDATE
+#include "bts_op_account_update.h"
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
+#include "bts_op_account_upgrade.h"
+#endif
+#ifdef HAVE_OP_PROPOSAL_CREATE
+#include "bts_op_proposal_create.h"
+#endif
+#ifdef HAVE_OP_BID_COLLATERAL
+#include "bts_op_bid_collateral.h"
+#endif
+
+/**
+ * Holds the deserialized form of any operation we know how to decode.  Lets a
+ * caller deserialize an operation into a single stack object without first
+ * switching on the operation type.
+ */
+typedef union bts_operation_u {
+    uint8_t                            none;    // In case no operations are built in
+#ifdef HAVE_OP_TRANSFER
+    bts_operation_transfer_t           transfer;
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
+    bts_operation_limit_order_create_t limitOrderCreate;
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CANCEL
+    bts_operation_limit_order_cancel_t limitOrderCancel;
+#endif
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+    bts_operation_call_order_update_t  callOrderUpdate;
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPDATE
+    bts_operation_account_update_t     accountUpdate;
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
+    bts_operation_account_upgrade_t    accountUpgrade;
+#endif
+#ifdef HAVE_OP_PROPOSAL_CREATE
+    bts_operation_proposal_create_t    proposalCreate;
+#endif
+#ifdef HAVE_OP_BID_COLLATERAL
+    bts_operation_bid_collateral_t     bidCollateral;
+#endif
+} bts_operation_u;
+
+/**
+ * Function prototype for operation deserializers, as stored in the registry.
+ */
+typedef btsDeserialStatus_e operation_deserializer_f (bts_cursor_t *cursor, bts_operation_u *op);
+
+/**
+ * Operation Registry: Everything the stream (ingest) phase and the display phase
+ * need to know about an operation, in one place.  The registry is a const table
+ * indexed by operationId_t, so lookup is O(1) and the two phases cannot disagree
+ * about whether an operation is supported.
+ *
+ * Pointer members hold link-time addresses.  Deref with PIC() before use, e.g.:
+ *   operation_parser_f * parser = PIC(getOperationInfo(opId)->parser);
+ */
+typedef struct operationInfo_t {
+    const char * name;                      // User-friendly operation name
+    operation_parser_f * parser;            // Display-phase argument printer
+    operation_deserializer_f * deserializer;// Validates cached payload at ingest.
+                                            // NULL if payload is not cached.
+    txProcessingState_e payloadState;       // Stream state that ingests the payload;
+                                            // this is the cache policy for the op.
+    uint8_t argumentCount;                  // Number of display arguments
+} operationInfo_t;
+
+/**
+ * Returns the registry entry for `opId`.  Never returns NULL: ids beyond the range
+ * of known operations resolve to an entry for unrecognized operations.
+ */
+const operationInfo_t * getOperationInfo(operationId_t opId);
+
+#endif
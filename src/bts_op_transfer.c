@@ -16,58 +16,27 @@
 *  limitations under the License.
 ********************************************************************************/
 
+#include "bts_op_config.h"
+
+#ifdef HAVE_OP_TRANSFER
+
 #include "bts_op_transfer.h"
 #include "bts_types.h"
 #include "os.h"
 
-uint32_t deserializeBtsOperationTransfer(const uint8_t *buffer, uint32_t bufferLength, bts_operation_transfer_t * op) {
-
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
-
-    gobbled = deserializeBtsAssetType(buffer, bufferLength, &op->feeAsset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsAccountIdType(buffer, bufferLength, &op->fromId);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsAccountIdType(buffer, bufferLength, &op->toId);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+btsDeserialStatus_e deserializeBtsOperationTransfer(bts_cursor_t *cursor, bts_operation_transfer_t * op) {
 
-    gobbled = deserializeBtsAssetType(buffer, bufferLength, &op->transferAsset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsAssetType(cursor, &op->feeAsset);
+    deserializeBtsAccountIdType(cursor, &op->fromId);
+    deserializeBtsAccountIdType(cursor, &op->toId);
+    deserializeBtsAssetType(cursor, &op->transferAsset);
+    deserializeBtsBoolType(cursor, &op->memoPresent);
 
-    gobbled = deserializeBtsBoolType(buffer, bufferLength, &op->memoPresent);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+    if (cursor->error == DESERIAL_OK && op->memoPresent) {
+        deserializeBtsMemoType(cursor, &op->memo);
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
 
-    if (op->memoPresent) {
-        gobbled = deserializeBtsMemoType(buffer, bufferLength, &op->memo);
-        if (gobbled > bufferLength) {
-            THROW(EXCEPTION);
-        }
-        read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-    }
-
-    gobbled = deserializeBtsExtensionArrayType(buffer, bufferLength, &op->extensions);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsExtensionArrayType(cursor, &op->extensions);
 
     if (op->extensions.count > 0) {
       op->containsUninterpretable = true;
@@ -75,8 +44,10 @@ uint32_t deserializeBtsOperationTransfer(const uint8_t *buffer, uint32_t bufferL
       op->containsUninterpretable = false;
     }
 
-    PRINTF("DESERIAL: OP_TRANSFER: Read %d bytes; Buffer remaining: %d bytes\n", read, bufferLength);
+    PRINTF("DESERIAL: OP_TRANSFER: Status %d; Buffer remaining: %d bytes\n", cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
+
+#endif
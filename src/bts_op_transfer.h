@@ -36,6 +36,6 @@ typedef struct bts_operation_transfer_t {
     bool containsUninterpretable;
 } bts_operation_transfer_t;
 
-uint32_t deserializeBtsOperationTransfer(const uint8_t *buffer, uint32_t bufferLength, bts_operation_transfer_t * op);
+btsDeserialStatus_e deserializeBtsOperationTransfer(bts_cursor_t *cursor, bts_operation_transfer_t * op);
 
 #endif
@@ -25,11 +25,31 @@
 ********************************************************************************/
 
 #include "bts_parse_operations.h"
+#include "bts_op_registry.h"
+#ifdef HAVE_OP_TRANSFER
 #include "bts_op_transfer.h"
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
 #include "bts_op_limit_order_create.h"
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CANCEL
 #include "bts_op_limit_order_cancel.h"
+#endif
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+#include "bts_op_call_order_update.h"
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPDATE
 #include "bts_op_account_update.h"
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
 #include "bts_op_account_upgrade.h"
+#endif
+#ifdef HAVE_OP_PROPOSAL_CREATE
+#include "bts_op_proposal_create.h"
+#endif
+#ifdef HAVE_OP_BID_COLLATERAL
+#include "bts_op_bid_collateral.h"
+#endif
 #include "bts_types.h"
 #include "app_ui_displays.h"
 #include "eos_utils.h"
@@ -43,168 +63,51 @@
 #define printfContentParam(...) snprintf(ui_buffers.sign_tx.paramValue, sizeof(ui_buffers.sign_tx.paramValue), __VA_ARGS__)
 #define WITH_SIZE(x) x, sizeof(x)
 
+#ifdef HAVE_OP_ANY
 /**
- * Global Resource: User-friendly Operation names.  These can be indexed by the
- * operationId enum in bts_stream.h.  E.g. op_name[OP_TRANSFER] should resolve to
- * a pointer to "Transfer".
+ * Payloads are validated at ingest, so this should be unreachable.  But if a cached
+ * payload fails to deserialize, say so rather than display uninitialized fields.
  */
-const char * const op_names[] = {   // Deref with PIC or you gone get bit. E.g.:
-    "Transfer",                     // const char * string = PIC(op_names[idx]);
-    "Limit Order",                  // Otherwise string gonna point to the dark
-    "Cancel Order",                 // and inky abyss.
-    "Adjust Collateral",
-    "fill_order", /* virtual */
-    "Register Account",
-    "Update Acct",
-    "Whitelist Account",
-    "Upgrade Acct",
-    "Transfer Account Ownership",
-    "Create Asset",
-    "asset_update",
-    "asset_update_bitasset",
-    "asset_update_feed_producers",
-    "asset_issue",
-    "asset_reserve",
-    "asset_fund_fee_pool",
-    "asset_settle",
-    "asset_global_settle",
-    "asset_publish_feed",
-    "witness_create",
-    "witness_update",
-    "proposal_create",
-    "proposal_update",
-    "proposal_delete",
-    "withdraw_permission_create",
-    "withdraw_permission_update",
-    "withdraw_permission_claim",
-    "withdraw_permission_delete",
-    "committee_member_create",
-    "committee_member_update",
-    "committee_member_update_global_parameters",
-    "vesting_balance_create",
-    "vesting_balance_withdraw",
-    "worker_create",
-    "custom",
-    "assert",
-    "balance_claim",
-    "override_transfer",
-    "transfer_to_blind",
-    "blind_transfer",
-    "transfer_from_blind",
-    "asset_settle_cancel", /* virtual */
-    "asset_claim_fees",
-    "fba_distribute", /* virtual */
-    "bid_collateral",
-    "execute_bid", /* virtual */
-    "asset_claim_pool",
-    "asset_update_issuer"
-};
+static void printMalformedOperation(uint8_t argNum) {
+    if (argNum == 0) {
+        printfContentLabel("Malformed");
+        printfContentParam("Operation");
+    } else {
+        printfContentLabel("Cannot");
+        printfContentParam("Display");
+    }
+}
+#endif
 
 void updateOperationContent() {
 
     const operationId_t opId = txContent.operationIds[txContent.currentOperation];
+    const operationInfo_t * opInfo = getOperationInfo(opId);
 
-    const char * opName = "";
-    if (opId < OP_NUM_KNOWN_OPS) {
-        opName = (const char *)PIC(op_names[opId]); // PIC or you gonna bleed...
-    }
-
-    switch (opId) {
-    case OP_TRANSFER:
-        txContent.argumentCount = 4;
-        txContent.operationParser = parseTransferOperation;
-        break;
-    case OP_LIMIT_ORDER_CREATE:
-        txContent.argumentCount = 6;
-        txContent.operationParser = parseLimitOrderCreateOperation;
-        break;
-    case OP_LIMIT_ORDER_CANCEL:
-        txContent.argumentCount = 3;
-        txContent.operationParser = parseLimitOrderCancelOperation;
-        break;
-    case OP_CALL_ORDER_UPDATE:  /* Unsupport */
-    case OP_FILL_ORDER:         /* Unsupport */ /* virtual */
-    case OP_ACCOUNT_CREATE:     /* Unsupport */
-        txContent.argumentCount = 2;
-        txContent.operationParser = parseUnsupportedOperation;
-        break;
-    case OP_ACCOUNT_UPDATE:
-        txContent.argumentCount = 5;
-        txContent.operationParser = parseAccountUpdateOperation;
-        break;
-    case OP_ACCOUNT_WHITELIST:  /* Unsupport */
-        txContent.argumentCount = 2;
-        txContent.operationParser = parseUnsupportedOperation;
-        break;
-    case OP_ACCOUNT_UPGRADE:
-        txContent.argumentCount = 3;
-        txContent.operationParser = parseAccountUpgradeOperation;
-        break;
-    case OP_ACCOUNT_TRANSFER:   /* Unsupport */
-    case OP_ASSET_CREATE:       // ...
-    case OP_ASSET_UPDATE:
-    case OP_ASSET_UPDATE_BITASSET:
-    case OP_ASSET_UPDATE_FEED_PRODUCERS:
-    case OP_ASSET_ISSUE:
-    case OP_ASSET_RESERVE:
-    case OP_ASSET_FUND_FEE_POOL:
-    case OP_ASSET_SETTLE:
-    case OP_ASSET_GLOBAL_SETTLE:
-    case OP_ASSET_PUBLISH_FEED:
-    case OP_WITNESS_CREATE:
-    case OP_WITNESS_UPDATE:
-    case OP_PROPOSAL_CREATE:
-    case OP_PROPOSAL_UPDATE:
-    case OP_PROPOSAL_DELETE:
-    case OP_WITHDRAW_PERMISSION_CREATE:
-    case OP_WITHDRAW_PERMISSION_UPDATE:
-    case OP_WITHDRAW_PERMISSION_CLAIM:
-    case OP_WITHDRAW_PERMISSION_DELETE:
-    case OP_COMMITTEE_MEMBER_CREATE:
-    case OP_COMMITTEE_MEMBER_UPDATE:
-    case OP_COMMITTEE_MEMBER_UPDATE_GLOBAL_PARAMETERS:
-    case OP_VESTING_BALANCE_CREATE:
-    case OP_VESTING_BALANCE_WITHDRAW:
-    case OP_WORKER_CREATE:
-    case OP_CUSTOM:
-    case OP_ASSERT:
-    case OP_BALANCE_CLAIM:
-    case OP_OVERRIDE_TRANSFER:
-    case OP_TRANSFER_TO_BLIND:
-    case OP_BLIND_TRANSFER:
-    case OP_TRANSFER_FROM_BLIND:
-    case OP_ASSET_SETTLE_CANCEL: /* virtual */
-    case OP_ASSET_CLAIM_FEES:
-    case OP_FBA_DISTRIBUTE:      /* virtual */
-    case OP_BID_COLLATERAL:
-    case OP_EXECUTE_BID:         /* virtual */
-    case OP_ASSET_CLAIM_POOL:
-    case OP_ASSET_UPDATE_ISSUER:
-        txContent.argumentCount = 2;
-        txContent.operationParser = parseUnsupportedOperation;
-        break;
-    default:
-        txContent.argumentCount = 2;
-        txContent.operationParser = parseUnknownOperation;
-        opName = "** Unknown Operation **";
-        break;
-    }
+    const char * opName = (const char *)PIC(opInfo->name); // PIC or you gonna bleed...
+    txContent.argumentCount = opInfo->argumentCount;
+    txContent.operationParser = (operation_parser_f *)PIC(opInfo->parser);
 
     os_memset(ui_buffers.sign_tx.paramValue, 0, sizeof(ui_buffers.sign_tx.paramValue));
-    os_memmove(ui_buffers.sign_tx.paramValue, opName,
-               MIN(sizeof(ui_buffers.sign_tx.paramValue)-1,strlen(opName)));
+    snprintf(ui_buffers.sign_tx.paramValue, sizeof(ui_buffers.sign_tx.paramValue), "%s%s",
+             txContent.operationProposed[txContent.currentOperation] ? "Proposed: " : "", opName);
     os_memset(ui_buffers.sign_tx.paramLabel, 0, sizeof(ui_buffers.sign_tx.paramLabel));
     snprintf(ui_buffers.sign_tx.paramLabel, sizeof(ui_buffers.sign_tx.paramLabel),
              "Operation %u of %u", txContent.currentOperation+1, txContent.operationCount);
 
 }
 
+#ifdef HAVE_OP_TRANSFER
 void parseTransferOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
-    uint32_t read = 0;
+    bts_cursor_t cursor;
     bts_operation_transfer_t op;
 
     // Read fields:
-    read += deserializeBtsOperationTransfer(buffer, bufferLength, &op);
+    initBtsCursor(&cursor, buffer, bufferLength);
+    if (deserializeBtsOperationTransfer(&cursor, &op) != DESERIAL_OK) {
+        printMalformedOperation(argNum);
+        return;
+    }
 
     if (argNum == 0) {
         printfContentLabel("Amount");
@@ -218,15 +121,28 @@ void parseTransferOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_
     } else if (argNum == 3) {
         printfContentLabel("Fee");
         prettyPrintBtsAssetType(op.feeAsset, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 4) {
+        printfContentLabel("Memo");
+        if (op.memoPresent) {
+            prettyPrintBtsMemoType(&op.memo, WITH_SIZE(ui_buffers.sign_tx.paramValue));
+        } else {
+            printfContentParam("(None)");
+        }
     }
 }
+#endif
 
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
 void parseLimitOrderCreateOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
-    uint32_t read = 0;
+    bts_cursor_t cursor;
     bts_operation_limit_order_create_t op;
 
     // Read fields:
-    read += deserializeBtsOperationLimitOrderCreate(buffer, bufferLength, &op);
+    initBtsCursor(&cursor, buffer, bufferLength);
+    if (deserializeBtsOperationLimitOrderCreate(&cursor, &op) != DESERIAL_OK) {
+        printMalformedOperation(argNum);
+        return;
+    }
 
     if (argNum == 0) {
         printfContentLabel("Seller");
@@ -248,13 +164,19 @@ void parseLimitOrderCreateOperation(const uint8_t *buffer, uint32_t bufferLength
         prettyPrintBtsAssetType(op.feeAsset, ui_buffers.sign_tx.paramValue);
     }
 }
+#endif
 
+#ifdef HAVE_OP_LIMIT_ORDER_CANCEL
 void parseLimitOrderCancelOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
-    uint32_t read = 0;
+    bts_cursor_t cursor;
     bts_operation_limit_order_cancel_t op;
 
     // Read fields:
-    read += deserializeBtsOperationLimitOrderCancel(buffer, bufferLength, &op);
+    initBtsCursor(&cursor, buffer, bufferLength);
+    if (deserializeBtsOperationLimitOrderCancel(&cursor, &op) != DESERIAL_OK) {
+        printMalformedOperation(argNum);
+        return;
+    }
 
     if (argNum == 0) {
         printfContentLabel("Account");
@@ -267,13 +189,54 @@ void parseLimitOrderCancelOperation(const uint8_t *buffer, uint32_t bufferLength
         prettyPrintBtsAssetType(op.feeAsset, ui_buffers.sign_tx.paramValue);
     }
 }
+#endif
+
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+void parseCallOrderUpdateOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
+    bts_cursor_t cursor;
+    bts_operation_call_order_update_t op;
+
+    // Read fields:
+    initBtsCursor(&cursor, buffer, bufferLength);
+    if (deserializeBtsOperationCallOrderUpdate(&cursor, &op) != DESERIAL_OK) {
+        printMalformedOperation(argNum);
+        return;
+    }
 
+    if (argNum == 0) {
+        printfContentLabel("Account");
+        prettyPrintBtsAccountIdType(op.fundingAccount, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 1) {
+        printfContentLabel("Collateral Change");
+        prettyPrintBtsAssetDelta(op.deltaCollateral, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 2) {
+        printfContentLabel("Debt Change");
+        prettyPrintBtsAssetDelta(op.deltaDebt, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 3) {
+        printfContentLabel("Target CR");
+        if (op.targetCRPresent) {
+            printfContentParam("%u.%03u", op.targetCR / 1000, op.targetCR % 1000);
+        } else {
+            printfContentParam("(None)");
+        }
+    } else if (argNum == 4) {
+        printfContentLabel("Fee");
+        prettyPrintBtsAssetType(op.feeAsset, ui_buffers.sign_tx.paramValue);
+    }
+}
+#endif
+
+#ifdef HAVE_OP_ACCOUNT_UPDATE
 void parseAccountUpdateOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
-    uint32_t read = 0;
+    bts_cursor_t cursor;
     bts_operation_account_update_t op;
 
     // Read fields:
-    read += deserializeBtsOperationAccountUpdate(buffer, bufferLength, &op);
+    initBtsCursor(&cursor, buffer, bufferLength);
+    if (deserializeBtsOperationAccountUpdate(&cursor, &op) != DESERIAL_OK) {
+        printMalformedOperation(argNum);
+        return;
+    }
 
     if (argNum == 0) {
         printfContentLabel("Account to Update");
@@ -354,13 +317,19 @@ void parseAccountUpdateOperation(const uint8_t *buffer, uint32_t bufferLength, u
         prettyPrintBtsAssetType(op.feeAsset, ui_buffers.sign_tx.paramValue);
     }
 }
+#endif
 
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
 void parseAccountUpgradeOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
-    uint32_t read = 0;
+    bts_cursor_t cursor;
     bts_operation_account_upgrade_t op;
 
     // Read fields:
-    read += deserializeBtsOperationAccountUpgrade(buffer, bufferLength, &op);
+    initBtsCursor(&cursor, buffer, bufferLength);
+    if (deserializeBtsOperationAccountUpgrade(&cursor, &op) != DESERIAL_OK) {
+        printMalformedOperation(argNum);
+        return;
+    }
 
     if (argNum == 0) {
         printfContentLabel("Account to Upgrade");
@@ -373,6 +342,82 @@ void parseAccountUpgradeOperation(const uint8_t *buffer, uint32_t bufferLength,
         prettyPrintBtsAssetType(op.feeAsset, ui_buffers.sign_tx.paramValue);
     }
 }
+#endif
+
+#ifdef HAVE_OP_PROPOSAL_CREATE
+void parseProposalCreateOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
+    bts_cursor_t cursor;
+    bts_operation_proposal_create_t op;
+
+    // Read fields:
+    initBtsCursor(&cursor, buffer, bufferLength);
+    if (deserializeBtsOperationProposalCreate(&cursor, &op) != DESERIAL_OK) {
+        printMalformedOperation(argNum);
+        return;
+    }
+
+    if (argNum == 0) {
+        printfContentLabel("Proposer");
+        prettyPrintBtsAccountIdType(op.feePayingAccount, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 1) {
+        // The proposed ops that had room in the cache follow this one, in order.
+        uint32_t shown = 0;
+        uint32_t i;
+        for (i = txContent.currentOperation + 1;
+             i < txContent.operationCount && txContent.operationProposed[i]; i++) {
+            shown++;
+        }
+        printfContentLabel("Proposed Ops");
+        if (shown < op.proposedOpsCount) {
+            printfContentParam("%u (%u not shown)", (unsigned int)op.proposedOpsCount,
+                               (unsigned int)(op.proposedOpsCount - shown));
+        } else {
+            printfContentParam("%u", (unsigned int)op.proposedOpsCount);
+        }
+    } else if (argNum == 2) {
+        printfContentLabel("Expires");
+        prettyPrintBtsTimeType(op.expirationTime, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 3) {
+        printfContentLabel("Review Period");
+        if (op.reviewPeriodPresent) {
+            printfContentParam("%u seconds", (unsigned int)op.reviewPeriodSeconds);
+        } else {
+            printfContentParam("(None)");
+        }
+    } else if (argNum == 4) {
+        printfContentLabel("Fee");
+        prettyPrintBtsAssetType(op.feeAsset, ui_buffers.sign_tx.paramValue);
+    }
+}
+#endif
+
+#ifdef HAVE_OP_BID_COLLATERAL
+void parseBidCollateralOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
+    bts_cursor_t cursor;
+    bts_operation_bid_collateral_t op;
+
+    // Read fields:
+    initBtsCursor(&cursor, buffer, bufferLength);
+    if (deserializeBtsOperationBidCollateral(&cursor, &op) != DESERIAL_OK) {
+        printMalformedOperation(argNum);
+        return;
+    }
+
+    if (argNum == 0) {
+        printfContentLabel("Bidder");
+        prettyPrintBtsAccountIdType(op.bidder, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 1) {
+        printfContentLabel("Collateral Bid");
+        prettyPrintBtsAssetType(op.additionalCollateral, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 2) {
+        printfContentLabel("Debt Covered");
+        prettyPrintBtsAssetType(op.debtCovered, ui_buffers.sign_tx.paramValue);
+    } else if (argNum == 3) {
+        printfContentLabel("Fee");
+        prettyPrintBtsAssetType(op.feeAsset, ui_buffers.sign_tx.paramValue);
+    }
+}
+#endif
 
 void parseUnsupportedOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum) {
 
@@ -20,12 +20,14 @@
 #define __BTS_PARSE_OPERATIONS_H__
 
 #include "bts_stream.h"
+#include "bts_op_config.h"
 
 
 /**
  * Updates operation-related members of the global `txContent` object to correspond
  * with the `currentOperation` member, which we assume has already been set.
- * Specifically, we update `argumentCount` and `operationParser`.  As an ancillary
+ * Specifically, we update `argumentCount` and `operationParser` from the operation
+ * registry (see bts_op_registry.h).  As an ancillary
  * side-effect, we also populate UI display buffers with the current operation name
  * and count to support user display.
  */
@@ -33,13 +35,32 @@ void updateOperationContent();
 
 /**
  * Parsers for various known operations. Handles stringification of operation arguments
- * for display to user.
+ * for display to user.  Only those selected in bts_op_config.h are built.
  */
+#ifdef HAVE_OP_TRANSFER
 void parseTransferOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum);
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
 void parseLimitOrderCreateOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum);
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CANCEL
 void parseLimitOrderCancelOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum);
+#endif
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+void parseCallOrderUpdateOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum);
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPDATE
 void parseAccountUpdateOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum);
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
 void parseAccountUpgradeOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum);
+#endif
+#ifdef HAVE_OP_PROPOSAL_CREATE
+void parseProposalCreateOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum);
+#endif
+#ifdef HAVE_OP_BID_COLLATERAL
+void parseBidCollateralOperation(const uint8_t *buffer, uint32_t bufferLength, uint8_t argNum);
+#endif
 
 /**
  * For operations that we know the name of but haven't written a parser for yet.
@@ -27,6 +27,9 @@
 #include <string.h>
 #include "bts_stream.h"
 #include "bts_parse_operations.h"
+#include "bts_op_registry.h"
+#include "bts_networks.h"
+#include "bts_totals.h"
 #include "bts_types.h"
 #include "os.h"
 #include "cx.h"
@@ -52,12 +55,11 @@ void initTxProcessingContent() { /* ConteNt */
     os_memset(&txContent, 0, sizeof(txProcessingContent_t));
 }
 
-uint8_t readTxByte(txProcessingContext_t *context) {
+/**
+ * Consumes one byte from the APDU buffer.  Caller must ensure commandLength > 0.
+ */
+static uint8_t readTxByte(txProcessingContext_t *context) {
     uint8_t data;
-    if (context->commandLength < 1) {
-        PRINTF("readTxByte Underflow\n");
-        THROW(EXCEPTION);
-    }
     data = *context->workBuffer;
     context->workBuffer++;
     context->commandLength--;
@@ -79,12 +81,12 @@ void printTxId(char * dispbuffer, size_t length) {
 void printTxOpArgument(uint8_t argNum) {
 
     const uint32_t opIdx = txContent.currentOperation;
-    const operationId_t opId = txContent.operationIds[opIdx];
     const uint32_t offset = (opIdx == 0) ? 0 : txContent.operationOffsets[opIdx-1];
     const uint8_t *buffer = txContent.operationDataBuffer + offset;
     const uint32_t bufferLength = txContent.operationOffsets[opIdx] - offset;
     PRINTF("Printing arg %u to op %u (id %u) at offset %u length %u; parser %p\n",
-           (uint32_t)argNum, opIdx, (uint32_t)opId, offset, bufferLength, txContent.operationParser);
+           (uint32_t)argNum, opIdx, (uint32_t)txContent.operationIds[opIdx], offset, bufferLength,
+           txContent.operationParser);
 
     /* Parser was pre-selected, call by function pointer: */
     txContent.operationParser(buffer, bufferLength, argNum);
@@ -128,6 +130,20 @@ static void processHelperGobbleCommandBytes(txProcessingContext_t *context, uint
     context->currentFieldPos += length;
 }
 
+/**
+ * Checks the TLV-declared length of the current field against what the field may
+ * legally hold.  Must pass before any bytes are gathered into a fixed-size buffer,
+ * since processHelperGobbleCommandBytes() copies as many as the TLV header says.
+ */
+static bool checkFieldLength(const txProcessingContext_t *context, uint32_t minLength, uint32_t maxLength) {
+    if (context->currentFieldLength < minLength || context->currentFieldLength > maxLength) {
+        PRINTF("Field length %u out of range [%u, %u] in state %u\n",
+               context->currentFieldLength, minLength, maxLength, context->state);
+        return false;
+    }
+    return true;
+}
+
 /**
  * Process all fields that do not requre any processing except hashing.
  * The data comes in by chucks, so it may happen that buffer may contain 
@@ -135,7 +151,11 @@ static void processHelperGobbleCommandBytes(txProcessingContext_t *context, uint
  * everything until it receives all data for a particular field 
  * and after that will move to next field.
 */
-static void processField(txProcessingContext_t *context) {
+static parserStatus_e processField(txProcessingContext_t *context, uint32_t expectedLength) {
+
+    if (!checkFieldLength(context, expectedLength, expectedLength)) {
+        return STREAM_FAULT;
+    }
 
     if (context->currentFieldPos < context->currentFieldLength) {
         processHelperGobbleCommandBytes(context, NULL);
@@ -145,32 +165,68 @@ static void processField(txProcessingContext_t *context) {
         context->state++;
         context->processingField = false;
     }
+    return STREAM_PROCESSING;
 }
 
 /**
  * Same as the generic processField() function, except we reinitialize the txIdSha256
- * hashing context so that ChainID is effectively excluded from that hash.
+ * hashing context so that ChainID is effectively excluded from that hash.  Also
+ * matches the ChainID against the known networks as it streams past, and keeps its
+ * leading bytes as a fingerprint in case it's not one of them.
 */
-static void processChainIdField(txProcessingContext_t *context) {
+static parserStatus_e processChainIdField(txProcessingContext_t *context) {
+
+    if (!checkFieldLength(context, CHAIN_ID_LENGTH, CHAIN_ID_LENGTH)) {
+        return STREAM_FAULT;
+    }
+
+    if (context->currentFieldPos == 0) {
+        context->networkCandidates = networkMatchBegin();
+    }
 
     if (context->currentFieldPos < context->currentFieldLength) {
+        const uint8_t *chunk = context->workBuffer;
+        const uint32_t offset = context->currentFieldPos;
         processHelperGobbleCommandBytes(context, NULL);
+        const uint32_t length = context->currentFieldPos - offset;
+        context->networkCandidates =
+            networkMatchUpdate(context->networkCandidates, offset, chunk, length);
+        if (offset < sizeof(txContent.chainIdFingerprint)) {
+            os_memmove(txContent.chainIdFingerprint + offset, chunk,
+                       MIN(length, sizeof(txContent.chainIdFingerprint) - offset));
+        }
     }
 
     if (context->currentFieldPos == context->currentFieldLength) {
+        txContent.network = networkMatchResult(context->networkCandidates);
         cx_sha256_init(context->txIdSha256);  // (Re-init to exclude ChainID)
         context->state++;
         context->processingField = false;
     }
+    return STREAM_PROCESSING;
+}
+
+/**
+ * Decodes the varint gathered into sizeBuffer, reading no further than the bytes
+ * actually gathered for the current field.  Returns false if malformed.
+ */
+static bool unpackSizeBuffer(txProcessingContext_t *context, uint32_t *value) {
+    const uint32_t length = MIN(context->currentFieldLength, sizeof(context->sizeBuffer));
+    const uint32_t read = unpack_varint32(context->sizeBuffer, length, value);
+    return (read != 0 && read <= length);
 }
 
 /**
  * Process Size fields that are expected to have Zero value. Except hashing the data, function
  * caches an incomming data. So, when all bytes for particulat field are received
  * do additional processing: Read actual number of actions encoded in buffer.
- * Throw exception if number is not '0'.
+ * Fault if number is not '0'.
 */
-static void processZeroSizeField(txProcessingContext_t *context) {
+static parserStatus_e processZeroSizeField(txProcessingContext_t *context) {
+
+    if (!checkFieldLength(context, 1, sizeof(context->sizeBuffer))) {
+        return STREAM_FAULT;
+    }
 
     if (context->currentFieldPos < context->currentFieldLength) {
         processHelperGobbleCommandBytes(context, context->sizeBuffer);
@@ -178,10 +234,9 @@ static void processZeroSizeField(txProcessingContext_t *context) {
 
     if (context->currentFieldPos == context->currentFieldLength) {
         uint32_t sizeValue = 0;
-        unpack_varint32(context->sizeBuffer, &sizeValue);
-        if (sizeValue != 0) {
+        if (!unpackSizeBuffer(context, &sizeValue) || sizeValue != 0) {
             PRINTF("processCtxFreeAction Action Number must be 0\n");
-            THROW(EXCEPTION);
+            return STREAM_FAULT;
         }
         // Reset size buffer
         os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
@@ -190,13 +245,18 @@ static void processZeroSizeField(txProcessingContext_t *context) {
         context->state++;
         context->processingField = false;
     }
+    return STREAM_PROCESSING;
 }
 
 /**
  * Process Operation Count Field. Initialize context members operationCount and
  * operationsRemaining.  Checks permitted values against TX_MIN/MAX_OPERATIONS.
  */
-static void processOperationListSizeField(txProcessingContext_t *context) {
+static parserStatus_e processOperationListSizeField(txProcessingContext_t *context) {
+
+    if (!checkFieldLength(context, 1, sizeof(context->sizeBuffer))) {
+        return STREAM_FAULT;
+    }
 
     if (context->currentFieldPos < context->currentFieldLength) {
         processHelperGobbleCommandBytes(context, context->sizeBuffer);
@@ -204,7 +264,10 @@ static void processOperationListSizeField(txProcessingContext_t *context) {
 
     if (context->currentFieldPos == context->currentFieldLength) {
         uint32_t sizeValue = 0;
-        unpack_varint32(context->sizeBuffer, &sizeValue);
+        if (!unpackSizeBuffer(context, &sizeValue)) {
+            PRINTF("processOperationListSizeField: Bad varint.\n");
+            return STREAM_FAULT;
+        }
         context->operationsRemaining = sizeValue;
         txContent.operationCount = 0;   // (Initial; Increments as OpIds read.)
 
@@ -213,19 +276,28 @@ static void processOperationListSizeField(txProcessingContext_t *context) {
 
         if (sizeValue < TX_MIN_OPERATIONS || sizeValue > TX_MAX_OPERATIONS) {
             PRINTF("processOperationListSizeField: Too many or too few operations.\n");
-            THROW(EXCEPTION);
+            return STREAM_FAULT;
         }
 
         // Move to next state
         context->state++;
         context->processingField = false;
     }
+    return STREAM_PROCESSING;
 }
 
 /**
- * Process Operation ID Field. Initialize context member currentOperationId.
+ * Process Operation ID Field. Initialize context member currentOperationId, and pick
+ * the payload state for the op from the registry.  Each op gets a slot in txContent,
+ * except that an op proposed within a TLV_OP_COMPLEX op gets one only if there's
+ * room for it while still leaving a slot for each top-level op yet to come.  Ops
+ * proposed within a proposed op never get one; we don't nest deeper than one level.
  */
-static void processOperationIdField(txProcessingContext_t *context) {
+static parserStatus_e processOperationIdField(txProcessingContext_t *context) {
+
+    if (!checkFieldLength(context, 1, sizeof(context->sizeBuffer))) {
+        return STREAM_FAULT;
+    }
 
     if (context->currentFieldPos < context->currentFieldLength) {
         processHelperGobbleCommandBytes(context, context->sizeBuffer);
@@ -233,36 +305,124 @@ static void processOperationIdField(txProcessingContext_t *context) {
 
     if (context->currentFieldPos == context->currentFieldLength) {
         uint32_t opIdValue = 0;
-        unpack_varint32(context->sizeBuffer, &opIdValue);
+        if (!unpackSizeBuffer(context, &opIdValue)) {
+            PRINTF("processOperationIdField: Bad varint.\n");
+            return STREAM_FAULT;
+        }
         context->currentOperationId = opIdValue;
+        const txProcessingState_e payloadState = getOperationInfo(opIdValue)->payloadState;
+
+        // Reset size buffer
+        os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
+        context->processingField = false;
+
+        if (context->nested
+            && (payloadState == TLV_OP_COMPLEX
+                || txContent.operationCount + 1 + context->operationsRemaining > TX_MAX_CACHED_OPS)) {
+            PRINTF("processOperationIdField: No slot for proposed op %u\n", opIdValue);
+            context->state = TLV_OP_ELIDED_PAYLOAD;
+            return STREAM_PROCESSING;
+        }
 
         // Push-back into Content structure
+        if (txContent.operationCount >= TX_MAX_CACHED_OPS) {
+            PRINTF("processOperationIdField: More ops than declared.\n");
+            return STREAM_FAULT;
+        }
         uint32_t opIdx = txContent.operationCount++;
         txContent.operationIds[opIdx] = opIdValue;
-
-        // Reset size buffer
-        os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
+        txContent.operationProposed[opIdx] = context->nested;
 
         // Move to next state
-        context->state++;
-        context->processingField = false;
+        context->state = payloadState;
     }
+    return STREAM_PROCESSING;
+}
+
+/**
+ * Drop the last proposed op cached before the current op, moving the payloads of the
+ * slots after it down.  The current op (the last slot) must have nothing cached yet.
+ * Proposed ops are dropped from the end of the list they are in, so the ones still
+ * shown are the first ones listed, as the proposal expects.  Returns false if there
+ * is no proposed op to drop.
+ */
+static bool evictProposedOperation() {
+
+    const uint32_t currentOpIdx = txContent.operationCount-1;
+    uint32_t opIdx = currentOpIdx;
+    uint32_t start, length, i;
+
+    while (opIdx > 0 && !txContent.operationProposed[opIdx-1]) {
+        opIdx--;
+    }
+    if (opIdx == 0) {
+        return false;
+    }
+    opIdx--;
+
+    start = (opIdx == 0) ? 0 : txContent.operationOffsets[opIdx-1];
+    length = txContent.operationOffsets[opIdx] - start;
+    os_memmove(txContent.operationDataBuffer + start,
+               txContent.operationDataBuffer + start + length,
+               txContent.operationOffsets[currentOpIdx-1] - start - length);
+    for (i = opIdx; i < currentOpIdx; i++) {
+        txContent.operationIds[i] = txContent.operationIds[i+1];
+        txContent.operationProposed[i] = txContent.operationProposed[i+1];
+        if (i+1 < currentOpIdx) {
+            txContent.operationOffsets[i] = txContent.operationOffsets[i+1] - length;
+        }
+    }
+    txContent.operationCount--;
+
+    PRINTF("Evicted %d bytes of proposed op from Op buffer\n", length);
+    return true;
+}
+
+/**
+ * True if `length` bytes, plus `reserved` more, fit behind the ops already cached.
+ */
+static bool hasRoomForOperation(uint32_t length, uint32_t reserved) {
+
+    const uint32_t currentOpIdx = txContent.operationCount-1;
+    const uint32_t opDataOffset = (currentOpIdx == 0) ? 0 : txContent.operationOffsets[currentOpIdx-1];
+    const uint32_t opBufferRemaining = (opDataOffset >= sizeof(txContent.operationDataBuffer))
+        ? 0: sizeof(txContent.operationDataBuffer) - opDataOffset;
+
+    return opBufferRemaining >= reserved && length <= opBufferRemaining - reserved;
 }
 
 /**
  * Process current operation payload field and store in into operation data buffer.
+ * Room is kept back for what is cached behind the payload later: the list size and
+ * tail of a complex op (see processComplexListSizeField()), or the tail of the
+ * complex op a proposed op is listed in.  Proposed ops only get what room is left
+ * over: a proposed op that doesn't fit is elided, and a top-level op that doesn't
+ * fit evicts proposed ops cached before it, rather than the transaction refused.
 */
-static void processOperationDataField(txProcessingContext_t *context) {
+static parserStatus_e processOperationDataField(txProcessingContext_t *context) {
+
+    const uint32_t reserved = context->nested ? sizeof(context->sizeBuffer)
+        : (context->state == TLV_OP_COMPLEX_PAYLOAD) ? 2 * sizeof(context->sizeBuffer) : 0;
+
+    if (context->currentFieldPos == 0 && !context->nested) {
+        while (!hasRoomForOperation(context->currentFieldLength, reserved)
+               && evictProposedOperation()) {
+        }
+    }
 
     const uint32_t currentOpIdx = txContent.operationCount-1;
     const uint32_t opDataOffset = (currentOpIdx == 0) ? 0 : txContent.operationOffsets[currentOpIdx-1];
     uint8_t* const currentOpBuffer = txContent.operationDataBuffer + opDataOffset;
-    const uint32_t opBufferRemaining = (opDataOffset >= sizeof(txContent.operationDataBuffer))
-        ? 0: sizeof(txContent.operationDataBuffer) - opDataOffset;
 
-    if (context->currentFieldLength > opBufferRemaining) {
+    if (!hasRoomForOperation(context->currentFieldLength, reserved)) {
+        if (context->nested && context->currentFieldPos == 0) {
+            PRINTF("processOperationData no room for proposed op; eliding\n");
+            txContent.operationCount--;
+            context->state = TLV_OP_ELIDED_PAYLOAD;
+            return STREAM_PROCESSING;
+        }
         PRINTF("processOperationData buffer overflow\n");
-        THROW(EXCEPTION);
+        return STREAM_FAULT;
     }
 
     if (context->currentFieldPos < context->currentFieldLength) {
@@ -277,6 +437,7 @@ static void processOperationDataField(txProcessingContext_t *context) {
         context->state++;
         context->processingField = false;
     }
+    return STREAM_PROCESSING;
 }
 
 /**
@@ -306,7 +467,210 @@ static void processUnsupportedOperationDataField(txProcessingContext_t *context)
     }
 }
 
+/**
+ * Process the payload field of a proposed op that has no slot in txContent: hash it,
+ * but neither cache it nor count it.  It is reported with the op that proposes it.
+ */
+static void processElidedOperationDataField(txProcessingContext_t *context) {
+
+    if (context->currentFieldPos < context->currentFieldLength) {
+        processHelperGobbleCommandBytes(context, NULL);
+    }
+
+    if (context->currentFieldPos == context->currentFieldLength) {
+        PRINTF("Elided %d bytes of proposed op\n", context->currentFieldLength);
+        context->state++;
+        context->processingField = false;
+    }
+}
+
+/**
+ * True if the op in slot `opIdx` has its payload cached, i.e. we can deserialize it.
+ */
+static bool isCachedOperation(uint32_t opIdx) {
+    return getOperationInfo(txContent.operationIds[opIdx])->deserializer != NULL;
+}
+
+/**
+ * Appends `length` bytes to the cached payload in slot `opIdx`, moving the payloads
+ * of any later slots up to make room.  Returns false if the buffer is full.
+ */
+static bool insertIntoCachedOperation(uint32_t opIdx, const uint8_t *data, uint32_t length) {
+
+    const uint32_t insertAt = txContent.operationOffsets[opIdx];
+    const uint32_t used = txContent.operationOffsets[txContent.operationCount-1];
+    uint32_t i;
+
+    if (length > sizeof(txContent.operationDataBuffer) - used) {
+        return false;
+    }
+    os_memmove(txContent.operationDataBuffer + insertAt + length,
+               txContent.operationDataBuffer + insertAt, used - insertAt);
+    os_memmove(txContent.operationDataBuffer + insertAt, data, length);
+    for (i = opIdx; i < txContent.operationCount; i++) {
+        txContent.operationOffsets[i] += length;
+    }
+    return true;
+}
+
+/**
+ * Process the size of the op list in a TLV_OP_COMPLEX op.  The size is cached with
+ * the op, so it can say how many ops it proposes, and then we go back to
+ * _OPERATION_CHECK_REMAIN to take the listed ops one at a time, nested.  Memory use
+ * does not depend on the size: listed ops are cached while there is room, and only
+ * hashed after that.
+ */
+static parserStatus_e processComplexListSizeField(txProcessingContext_t *context) {
+
+    if (!checkFieldLength(context, 1, sizeof(context->sizeBuffer))) {
+        return STREAM_FAULT;
+    }
+
+    if (context->currentFieldPos < context->currentFieldLength) {
+        processHelperGobbleCommandBytes(context, context->sizeBuffer);
+    }
+
+    if (context->currentFieldPos == context->currentFieldLength) {
+        uint32_t sizeValue = 0;
+        // The field is cached as-is, so it must hold the varint and nothing else.
+        if (unpack_varint32(context->sizeBuffer, context->currentFieldLength, &sizeValue)
+                != context->currentFieldLength || sizeValue == 0) {
+            PRINTF("processComplexListSizeField: Bad or empty op list size.\n");
+            return STREAM_FAULT;
+        }
+        const uint32_t opDataOffset = (context->complexOpIdx == 0)
+            ? 0 : txContent.operationOffsets[context->complexOpIdx-1];
+        context->complexHeadLength = txContent.operationOffsets[context->complexOpIdx] - opDataOffset;
+        if (isCachedOperation(context->complexOpIdx)
+            && !insertIntoCachedOperation(context->complexOpIdx, context->sizeBuffer,
+                                          context->currentFieldLength)) {
+            PRINTF("processComplexListSizeField: Op buffer overflow\n");
+            return STREAM_FAULT;
+        }
+        context->nested = true;
+        context->nestedOpsRemaining = sizeValue;
+        context->nestedOpsStreamed = 0;
+
+        // Reset size buffer
+        os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
+
+        context->state = TLV_OPERATION_CHECK_REMAIN;
+        context->processingField = false;
+    }
+    return STREAM_PROCESSING;
+}
+
+/**
+ * Process the fields following the op list of a TLV_OP_COMPLEX op.  For a proposal
+ * that's the optional review period and the extensions, at most 6 bytes unless there
+ * are extensions; we gather them in sizeBuffer and add them to the cached op, behind
+ * the list size.  Proposed ops cached since then leave room for this.
+ */
+static parserStatus_e processComplexTailField(txProcessingContext_t *context) {
+
+    if (!checkFieldLength(context, 2, sizeof(context->sizeBuffer))) {
+        return STREAM_FAULT;
+    }
+
+    if (context->currentFieldPos < context->currentFieldLength) {
+        processHelperGobbleCommandBytes(context, context->sizeBuffer);
+    }
+
+    if (context->currentFieldPos == context->currentFieldLength) {
+        if (isCachedOperation(context->complexOpIdx)
+            && !insertIntoCachedOperation(context->complexOpIdx, context->sizeBuffer,
+                                          context->currentFieldLength)) {
+            PRINTF("processComplexTailField: Op buffer overflow\n");
+            return STREAM_FAULT;
+        }
+        context->nested = false;
+
+        // Reset size buffer
+        os_memset(context->sizeBuffer, 0, sizeof(context->sizeBuffer));
+
+        context->state++;
+        context->processingField = false;
+    }
+    return STREAM_PROCESSING;
+}
+
+/**
+ * Deserialize the cached operation payload in slot `opIdx` with the deserializer
+ * registered for its OpId, into `op`.  The display phase will deserialize the same
+ * bytes again, so by checking here a malformed payload is rejected before the user is
+ * ever asked to review it.  The payload must be consumed exactly: its bounds are set
+ * by the host, and bytes the deserializer didn't read would be signed unseen.  While
+ * we have it deserialized, add what it spends to the totals, unless it is only
+ * proposed.
+ */
+static parserStatus_e validateCachedOperation(txProcessingContext_t *context, uint32_t opIdx,
+                                              bts_operation_u *op) {
+
+    const uint32_t opDataOffset = (opIdx == 0) ? 0 : txContent.operationOffsets[opIdx-1];
+    const operationInfo_t * opInfo = getOperationInfo(txContent.operationIds[opIdx]);
+    operation_deserializer_f * deserializer = (operation_deserializer_f *)PIC(opInfo->deserializer);
+    bts_cursor_t cursor;
+
+    if (deserializer == NULL) {
+        PRINTF("validateCachedOperation: No deserializer for cached op\n");
+        return STREAM_FAULT;
+    }
+
+    initBtsCursor(&cursor, txContent.operationDataBuffer + opDataOffset,
+                  txContent.operationOffsets[opIdx] - opDataOffset);
+    if (deserializer(&cursor, op) != DESERIAL_OK) {
+        PRINTF("validateCachedOperation: Deserialization failed: %d\n", cursor.error);
+        return STREAM_FAULT;
+    }
+    if (cursor.remaining != 0) {
+        PRINTF("validateCachedOperation: %d bytes left over\n", cursor.remaining);
+        return STREAM_FAULT;
+    }
+
+    if (!txContent.operationProposed[opIdx]
+        && !addOperationToTotals(txContent.operationIds[opIdx], op)) {
+        PRINTF("validateCachedOperation: Totals overflow\n");
+        return STREAM_FAULT;
+    }
+
+    return STREAM_PROCESSING;
+}
+
+static parserStatus_e validateSimpleOperation(txProcessingContext_t *context) {
+    bts_operation_u op;
+    return validateCachedOperation(context, txContent.operationCount-1, &op);
+}
+
+/**
+ * As validateSimpleOperation(), for the op holding an op list.  The list size was
+ * cached between the fields streamed before and after the list, so the deserializer
+ * must find it exactly there, and it must count the ops actually streamed.  Otherwise
+ * the host could shift field bounds, and we'd show a different op than is signed.
+ */
+static parserStatus_e validateComplexOperation(txProcessingContext_t *context) {
+    bts_operation_u op;
+    const parserStatus_e status = validateCachedOperation(context, context->complexOpIdx, &op);
+
+    if (status != STREAM_PROCESSING) {
+        return status;
+    }
+#ifdef HAVE_OP_PROPOSAL_CREATE
+    if (txContent.operationIds[context->complexOpIdx] == OP_PROPOSAL_CREATE) {
+        const uint32_t opDataOffset = (context->complexOpIdx == 0)
+            ? 0 : txContent.operationOffsets[context->complexOpIdx-1];
+        if (op.proposalCreate.pProposedOpsCount != txContent.operationDataBuffer
+                + opDataOffset + context->complexHeadLength
+            || op.proposalCreate.proposedOpsCount != context->nestedOpsStreamed) {
+            PRINTF("validateComplexOperation: Op list size mismatch\n");
+            return STREAM_FAULT;
+        }
+    }
+#endif
+    return STREAM_PROCESSING;
+}
+
 static parserStatus_e processTxInternal(txProcessingContext_t *context) {
+    parserStatus_e status = STREAM_PROCESSING;
     for(;;) {
         if (context->state == TLV_DONE) {
             return STREAM_FINISHED;
@@ -350,21 +714,32 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
         }
         switch (context->state) {
         case TLV_CHAIN_ID:
-            processChainIdField(context);
+            status = processChainIdField(context);
             break;
 
-        case TLV_HEADER_EXPIRATION:
         case TLV_HEADER_REF_BLOCK_NUM:
+            status = processField(context, sizeof(uint16_t));
+            break;
+
         case TLV_HEADER_REF_BLOCK_PREFIX:
-            processField(context);
+        case TLV_HEADER_EXPIRATION:
+            status = processField(context, sizeof(uint32_t));
             break;
 
         case TLV_OPERATION_LIST_SIZE:
-            processOperationListSizeField(context);
+            status = processOperationListSizeField(context);
             break;
 
         case TLV_OPERATION_CHECK_REMAIN:
-            if(context->operationsRemaining > 0) {
+            if (context->nested) {
+                if (context->nestedOpsRemaining > 0) {
+                    context->nestedOpsRemaining--;
+                    context->nestedOpsStreamed++;
+                    context->state = TLV_OPERATION_ID;
+                } else {
+                    context->state = TLV_OP_COMPLEX_TAIL;
+                }
+            } else if(context->operationsRemaining > 0) {
                 context->operationsRemaining--;
                 context->state = TLV_OPERATION_ID;
             } else {
@@ -373,28 +748,41 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
             break;
 
         case TLV_OPERATION_ID:
-            processOperationIdField(context);
-            if(!context->processingField) {             // if (we extracted an OpId) {
-                switch (context->currentOperationId) {  //    then pick next state based on OpId
-                    case OP_TRANSFER:
-                    case OP_LIMIT_ORDER_CREATE:
-                    case OP_LIMIT_ORDER_CANCEL:
-                    case OP_ACCOUNT_UPDATE:
-                    case OP_ACCOUNT_UPGRADE:
-                        context->state = TLV_OP_SIMPLE;
-                        break;
-                    default:
-                        context->state = TLV_OP_UNSUPPORTED;
-                        break;
-                }
-            }
+            status = processOperationIdField(context); // Picks next state based on OpId
             break;
 
         case TLV_OP_SIMPLE_PAYLOAD:
-            processOperationDataField(context);
+            status = processOperationDataField(context);
             break;
 
         case TLV_OP_SIMPLE_DONE:
+            status = validateSimpleOperation(context);
+            context->state = TLV_OPERATION_CHECK_REMAIN;    // Go back and see if more operations
+            break;
+
+        case TLV_OP_COMPLEX_PAYLOAD:
+            context->complexOpIdx = txContent.operationCount-1;
+            if (isCachedOperation(context->complexOpIdx)) {
+                status = processOperationDataField(context);
+            } else {
+                processUnsupportedOperationDataField(context);
+            }
+            break;
+
+        case TLV_OP_COMPLEX_OP_LIST_SIZE:
+            status = processComplexListSizeField(context);
+            break;
+
+        case TLV_OP_COMPLEX_TAIL:
+            status = processComplexTailField(context);
+            break;
+
+        case TLV_OP_COMPLEX_DONE:
+            if (isCachedOperation(context->complexOpIdx)) {
+                status = validateComplexOperation(context);
+            } else {
+                txContent.uncountedOps++;
+            }
             context->state = TLV_OPERATION_CHECK_REMAIN;    // Go back and see if more operations
             break;
 
@@ -403,17 +791,31 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
             break;
 
         case TLV_OP_UNSUPPORTED_DONE:
+            if (!context->nested) {
+                txContent.uncountedOps++;
+            }
+            context->state = TLV_OPERATION_CHECK_REMAIN;    // Go back and see if more operations
+            break;
+
+        case TLV_OP_ELIDED_PAYLOAD:
+            processElidedOperationDataField(context);
+            break;
+
+        case TLV_OP_ELIDED_DONE:
             context->state = TLV_OPERATION_CHECK_REMAIN;    // Go back and see if more operations
             break;
 
         case TLV_TX_EXTENSION_LIST_SIZE:
-            processZeroSizeField(context);
+            status = processZeroSizeField(context);
             break;
 
         default:
             PRINTF("Invalid TLV decoder context\n");
             return STREAM_FAULT;
         }
+        if (status == STREAM_FAULT) {
+            return STREAM_FAULT;
+        }
     }
 }
 
@@ -466,26 +868,10 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
  * CTX_FREE_ACTION_DATA_NUMBER theoretically is not fixed due to serialization. Ledger accepts only 0 as encoded value.
 */
 parserStatus_e processTxStream(const uint8_t *buffer, uint32_t length) {
-    parserStatus_e result;
-#ifdef DEBUG_APP
-    // Do not catch exceptions.
+    // Parse errors are reported by status, all the way up from the deserializers,
+    // so no TRY context is needed here.  (Exceptions are handled at the APDU
+    // dispatch in main.c.)
     txStreamContext.workBuffer = buffer;
     txStreamContext.commandLength = length;
-    result = processTxInternal(&txStreamContext);
-#else
-    BEGIN_TRY {
-        TRY {
-            txStreamContext.workBuffer = buffer;
-            txStreamContext.commandLength = length;
-            result = processTxInternal(&txStreamContext);
-        }
-        CATCH_OTHER(e) {
-            result = STREAM_FAULT;
-        }
-        FINALLY {
-        }
-    }
-    END_TRY;
-#endif
-    return result;
+    return processTxInternal(&txStreamContext);
 }
@@ -31,11 +31,18 @@
 #include "cx.h"
 #include <stdbool.h>
 #include "bts_types.h"
+#include "bts_t_asset.h"
 
 /* Limits on allowed transaction parameters that we will accept. (These
  * are not BitShares limits but rather limits in what we will handle.) */
 #define TX_MIN_OPERATIONS 1
 #define TX_MAX_OPERATIONS 4
+#define TX_MAX_TOTALS (3 * TX_MAX_OPERATIONS) /* Fee and up to two other assets per
+                                              * op (call_order_update) */
+#define TX_MAX_CACHED_OPS (2 * TX_MAX_OPERATIONS) /* Top-level ops, plus any ops
+                                         * proposed within them that we show */
+
+#define CHAIN_ID_LENGTH 32  // Chain ID is a SHA256 digest
 
 enum {
     OP_TRANSFER = 0,
@@ -119,6 +126,9 @@ typedef struct txProcessingContent_t {
 
     uint8_t txIdHash[32];               /* Not same as message hash; this is for TxID as
                                          * would be shown on a block explorer. */
+    uint8_t network;                    /* Index of the ChainID in the known networks
+                                         * table (bts_networks.h), or NETWORK_UNKNOWN */
+    uint8_t chainIdFingerprint[4];      /* Leading ChainID bytes, shown if unknown */
     uint8_t argumentCount;              /* Argument count for *current* operation being
                                          * parsed */
     uint8_t subargRemainP1;             /* Some arguments have subarguments. ux_step
@@ -133,12 +143,19 @@ typedef struct txProcessingContent_t {
                                          */
     operation_parser_f *operationParser;/* Function pointer to parser appropriate for
                                          * current operation */
-    operationId_t operationIds[TX_MAX_OPERATIONS];/* OpId's of cached operation
+    operationId_t operationIds[TX_MAX_CACHED_OPS];/* OpId's of cached operation
                                                    * payloads */
-    uint32_t operationOffsets[TX_MAX_OPERATIONS]; /* Offsets of NEXT payloads in buffer.
+    uint32_t operationOffsets[TX_MAX_CACHED_OPS]; /* Offsets of NEXT payloads in buffer.
                                                    * Last used is offset to end+1 of the
                                                    * buffer and gives a total used length
                                                    * of the buffer */
+    bool operationProposed[TX_MAX_CACHED_OPS];    /* True if op is proposed within a
+                                                   * proposal_create rather than
+                                                   * executed by this transaction */
+    bts_asset_type_t totals[TX_MAX_TOTALS];/* Spent per asset, across all ops; see
+                                         * bts_totals.h */
+    uint8_t totalsCount;                /* Entries used in totals */
+    uint8_t uncountedOps;               /* Ops whose spending is not in totals */
     uint8_t operationDataBuffer[768];   /* Cache for Operation data.  We transcribe
                                          * recognized transaction payloads back-to-back in
                                          * this buffer for later parsing.  We use the
@@ -166,12 +183,17 @@ typedef enum txProcessingState_e {
     TLV_OP_SIMPLE,              // For simple, known operations. Hash and cache payload.
     TLV_OP_SIMPLE_PAYLOAD = TLV_OP_SIMPLE,
     TLV_OP_SIMPLE_DONE,         //   Return: goes back to _OPERATION_CHECK_REMAIN
-    TLV_OP_COMPLEX,             // For complex ops where payload needs special handling
-    TLV_OP_COMPLEX_PAYLOAD = TLV_OP_COMPLEX,            // before cacheing.
-    TLV_OP_COMPLEX_DONE,        //   Return: goes back to _OPERATION_CHECK_REMAIN
+    TLV_OP_COMPLEX,             // For ops holding a list of ops (proposal_create).  The
+    TLV_OP_COMPLEX_PAYLOAD = TLV_OP_COMPLEX,            // host sends fields before the
+    TLV_OP_COMPLEX_OP_LIST_SIZE,//   list, the list size, each listed op as an OpId and
+    TLV_OP_COMPLEX_TAIL,        //   payload, then fields after the list.  Listed ops go
+    TLV_OP_COMPLEX_DONE,        //   through _OPERATION_CHECK_REMAIN and _ID, nested.
     TLV_OP_UNSUPPORTED,         // For unknown or unsupported operations. Hash, but
     TLV_OP_UNSUPPORTED_PAYLOAD = TLV_OP_UNSUPPORTED,    // do not cache.
     TLV_OP_UNSUPPORTED_DONE,    //   Return: goes back to _OPERATION_CHECK_REMAIN
+    TLV_OP_ELIDED,              // For proposed ops we have no room to show. Hash, but
+    TLV_OP_ELIDED_PAYLOAD = TLV_OP_ELIDED,              // take no slot in txContent.
+    TLV_OP_ELIDED_DONE,         //   Return: goes back to _OPERATION_CHECK_REMAIN
 } txProcessingState_e;
 
 typedef struct txProcessingContext_t {
@@ -182,12 +204,18 @@ typedef struct txProcessingContext_t {
     uint32_t currentFieldPos;
     uint32_t operationsRemaining;   // bitshares
     uint32_t currentOperationId;    // bitshares
+    bool nested;              // True: within the op list of a TLV_OP_COMPLEX op
+    uint32_t nestedOpsRemaining;    // Ops left in that list
+    uint32_t nestedOpsStreamed;     // Ops of that list streamed so far
+    uint32_t complexOpIdx;    // txContent slot of the op holding the list
+    uint32_t complexHeadLength;     // Bytes of that op cached ahead of the list size
     bool processingField;     // True: processing a field; False: decoding TLV header.
     uint8_t tlvBuffer[5];     // TODO: Does this need to be six?
     uint32_t tlvBufferPos;
     const uint8_t *workBuffer;// Points into the APDU buffer. Increment as we process.
     uint32_t commandLength;   // Bytes remaining in APDU buffer rel to workBuffer.
     uint8_t sizeBuffer[12];   // Used for caching VarInts for decoding
+    uint8_t networkCandidates;// Known networks whose ChainID matches so far
 } txProcessingContext_t;
 
 typedef enum parserStatus_e {
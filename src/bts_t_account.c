@@ -17,25 +17,19 @@
 ********************************************************************************/
 
 #include "bts_t_account.h"
+#include "bts_t_varint.h"
 #include "bts_types.h"
 #include "eos_utils.h"
 #include "os.h"
 #include <string.h>
 
-uint32_t deserializeBtsAccountIdType(const uint8_t *buffer, uint32_t bufferLength, bts_account_id_type_t * account) {
+btsDeserialStatus_e deserializeBtsAccountIdType(bts_cursor_t *cursor, bts_account_id_type_t * account) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+    deserializeBtsVarint48Type(cursor, account);
 
-    gobbled = unpack_varint48(buffer, account);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    PRINTF("DESERIAL: ACCOUNT_ID: Read %d bytes; %d bytes remain\n", read, bufferLength);
+    PRINTF("DESERIAL: ACCOUNT_ID: Status %d; %d bytes remain\n", cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
 
@@ -19,11 +19,12 @@
 #ifndef __BTS_T_ACCOUNT_H__
 #define __BTS_T_ACCOUNT_H__
 
+#include "bts_types.h"
 #include "os.h"
 
 typedef uint64_t bts_account_id_type_t;
 
-uint32_t deserializeBtsAccountIdType(const uint8_t *buffer, uint32_t bufferLength, bts_account_id_type_t * asset);
+btsDeserialStatus_e deserializeBtsAccountIdType(bts_cursor_t *cursor, bts_account_id_type_t * asset);
 
 uint32_t prettyPrintBtsAccountIdType(bts_account_id_type_t asset, char * buffer);
 
@@ -21,76 +21,34 @@
 #include "os.h"
 #include <string.h>
 
-uint32_t deserializeBtsAccountOptionsType(const uint8_t *buffer, uint32_t bufferLength, bts_account_options_type_t * opts) {
+btsDeserialStatus_e deserializeBtsAccountOptionsType(bts_cursor_t *cursor, bts_account_options_type_t * opts) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+    deserializeBtsPublicKeyType(cursor, &opts->memoPubkey);
+    deserializeBtsAccountIdType(cursor, &opts->votingAccount);
+    cursorReadBytes(cursor, &opts->numWitnesses, sizeof(uint16_t));
+    cursorReadBytes(cursor, &opts->numCommittee, sizeof(uint16_t));
+    deserializeBtsVarint32Type(cursor, &opts->numVotes);
 
-    gobbled = deserializeBtsPublicKeyType(buffer, bufferLength, &opts->memoPubkey);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = deserializeBtsAccountIdType(buffer, bufferLength, &opts->votingAccount);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = sizeof(uint16_t);
-    os_memmove(&opts->numWitnesses, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = sizeof(uint16_t);
-    os_memmove(&opts->numCommittee, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    opts->votes = cursor->ptr;
 
-    gobbled = deserializeBtsVarint32Type(buffer, bufferLength, &opts->numVotes);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    opts->votes = buffer;
-
-    gobbled = opts->numVotes * sizeof(bts_vote_type_t); // Seek past vote array
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+    if (cursor->error == DESERIAL_OK) {     // Seek past vote array
+        if (opts->numVotes > cursor->remaining / sizeof(bts_vote_type_t)) {
+            cursorFail(cursor, DESERIAL_UNDERFLOW);
+        }
+        cursorReadBytes(cursor, NULL, opts->numVotes * sizeof(bts_vote_type_t));
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
 
-    gobbled = deserializeBtsExtensionArrayType(buffer, bufferLength, &opts->extensions);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsExtensionArrayType(cursor, &opts->extensions);
 
-    PRINTF("DESERIAL: ACCT_OPTS: Read %d bytes; %d bytes remain\n", read, bufferLength);
+    PRINTF("DESERIAL: ACCT_OPTS: Status %d; %d bytes remain\n", cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
 
-uint32_t deserializeBtsVoteType(const uint8_t *buffer, uint32_t bufferLength, bts_vote_type_t * vote) {
-
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
-
-    gobbled = sizeof(uint32_t);
-    os_memmove(vote, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+btsDeserialStatus_e deserializeBtsVoteType(bts_cursor_t *cursor, bts_vote_type_t * vote) {
 
-    return read;
+    return cursorReadBytes(cursor, vote, sizeof(uint32_t));
 
 }
 
@@ -115,7 +73,9 @@ uint32_t prettyPrintBtsVotesList(bts_account_options_type_t opts, char * buffer,
     } else {
         for (uint32_t i = 0; i < opts.numVotes; i++) {
             bts_vote_type_t tmpVote;
-            deserializeBtsVoteType(opts.votes + i * sizeof(bts_vote_type_t), -1, &tmpVote);
+            bts_cursor_t cursor;
+            initBtsCursor(&cursor, (const uint8_t *)opts.votes + i * sizeof(bts_vote_type_t), -1);
+            deserializeBtsVoteType(&cursor, &tmpVote);
             prettyPrintBtsVoteType(tmpVote, buffer+written, bufferLength-written);
             written = strlen(buffer);
             if (i+1 != opts.numVotes) {
@@ -38,8 +38,8 @@ typedef struct bts_account_options_type_t {
 
 typedef uint32_t bts_vote_type_t;
 
-uint32_t deserializeBtsAccountOptionsType(const uint8_t *buffer, uint32_t bufferLength, bts_account_options_type_t * opts);
-uint32_t deserializeBtsVoteType(const uint8_t *buffer, uint32_t bufferLength, bts_vote_type_t * vote);
+btsDeserialStatus_e deserializeBtsAccountOptionsType(bts_cursor_t *cursor, bts_account_options_type_t * opts);
+btsDeserialStatus_e deserializeBtsVoteType(bts_cursor_t *cursor, bts_vote_type_t * vote);
 
 uint32_t prettyPrintBtsVoteType(bts_vote_type_t vote, char * buffer, uint32_t bufferLength);
 uint32_t prettyPrintBtsVotesList(bts_account_options_type_t opts, char * buffer, uint32_t bufferLength);
@@ -17,33 +17,21 @@
 ********************************************************************************/
 
 #include "bts_t_asset.h"
+#include "bts_t_varint.h"
 #include "bts_types.h"
 #include "eos_utils.h"
 #include "os.h"
 #include <string.h>
 
-uint32_t deserializeBtsAssetType(const uint8_t *buffer, uint32_t bufferLength, bts_asset_type_t * asset) {
+btsDeserialStatus_e deserializeBtsAssetType(bts_cursor_t *cursor, bts_asset_type_t * asset) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+    cursorReadBytes(cursor, &asset->amount, sizeof(uint64_t));
+    deserializeBtsVarint48Type(cursor, &asset->instanceId);
 
-    gobbled = sizeof(uint64_t);
-    os_memmove(&asset->amount, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = unpack_varint48(buffer, &asset->instanceId);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    PRINTF("DESERIAL: ASSET: %d [1.3.%d]; Status %d; %d bytes remain\n",
+           (int)asset->amount, (int)asset->instanceId, cursor->error, cursor->remaining);
 
-    PRINTF("DESERIAL: ASSET: %d [1.3.%d]; Read %d bytes; %d bytes remain\n",
-           (int)asset->amount, (int)asset->instanceId, read, bufferLength);
-
-    return read;
+    return cursor->error;
 
 }
 
@@ -95,6 +83,17 @@ uint32_t prettyPrintBtsAssetType(const bts_asset_type_t asset, char * buffer) {
     return written;
 }
 
+uint32_t prettyPrintBtsAssetDelta(bts_asset_type_t asset, char * buffer) {
+
+    const bool negative = ((int64_t)asset.amount < 0);
+
+    buffer[0] = negative ? '-' : '+';
+    if (negative) {
+        asset.amount = (uint64_t)0 - asset.amount;  // Magnitude; fine for INT64_MIN too
+    }
+    return 1 + prettyPrintBtsAssetType(asset, buffer+1);
+}
+
 bool getBtsAssetDescription(const bts_asset_type_t asset, bts_asset_description_t *desc) {
 
     uint32_t written = 0;
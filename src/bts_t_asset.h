@@ -20,6 +20,7 @@
 #define __BTS_T_ASSET_H__
 
 #include <stdbool.h>
+#include "bts_types.h"
 #include "os.h"
 
 typedef struct bts_asset_type_t {
@@ -33,10 +34,16 @@ typedef struct bts_asset_description_t {
                         // '[1.3.xxx]' for largest instanceId
 } bts_asset_description_t;
 
-uint32_t deserializeBtsAssetType(const uint8_t *buffer, uint32_t bufferLength, bts_asset_type_t * asset);
+btsDeserialStatus_e deserializeBtsAssetType(bts_cursor_t *cursor, bts_asset_type_t * asset);
 
 uint32_t prettyPrintBtsAssetType(bts_asset_type_t asset, char * buffer);
 
+/**
+ * As prettyPrintBtsAssetType(), but for amounts that are signed changes, such as
+ * the collateral and debt deltas of call_order_update.  Prints a leading '+' or '-'.
+ */
+uint32_t prettyPrintBtsAssetDelta(bts_asset_type_t asset, char * buffer);
+
 bool getBtsAssetDescription(bts_asset_type_t asset, bts_asset_description_t *desc);
 
 #endif
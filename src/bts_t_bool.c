@@ -20,25 +20,18 @@
 #include "bts_t_bool.h"
 #include "os.h"
 
-uint32_t deserializeBtsBoolType(const uint8_t *buffer, uint32_t bufferLength, bts_bool_type_t * asset) {
+btsDeserialStatus_e deserializeBtsBoolType(bts_cursor_t *cursor, bts_bool_type_t * asset) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
-    uint8_t temp;
+    uint8_t temp = 0;
 
-    gobbled = sizeof(uint8_t);          // BTS Bool is one byte, on the wire.
-    os_memmove(&temp, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    cursorReadBytes(cursor, &temp, sizeof(uint8_t));   // BTS Bool is one byte, on the wire.
 
     *asset = temp ? true : false;       // But stdlib bool could be a different width
 
-    PRINTF("DESERIAL: BOOL: %d; Read %d bytes; %d bytes remain\n",
-           (int)(*asset), read, bufferLength);
+    PRINTF("DESERIAL: BOOL: %d; Status %d; %d bytes remain\n",
+           (int)(*asset), cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
 
@@ -20,6 +20,7 @@
 #define __BTS_T_BOOL_H__
 
 #include <stdbool.h>
+#include "bts_types.h"
 #include "os.h"
 
 typedef bool bts_bool_type_t;
@@ -28,7 +29,7 @@ typedef bool bts_bool_type_t;
  * Conversion from over-the-wire to stdlib bool type.  BitShares uses a single
  * byte for bool.  Stdlib may use a different width.
  */
-uint32_t deserializeBtsBoolType(const uint8_t *buffer, uint32_t bufferLength, bts_bool_type_t * asset);
+btsDeserialStatus_e deserializeBtsBoolType(bts_cursor_t *cursor, bts_bool_type_t * asset);
 
 /**
  * Prints to buffer as "True" or "False".
@@ -19,27 +19,20 @@
 #include "bts_t_extensions.h"
 #include "os.h"
 
-uint32_t deserializeBtsExtensionArrayType(const uint8_t *buffer, uint32_t bufferLength, bts_extension_array_type_t * exts) {
+btsDeserialStatus_e deserializeBtsExtensionArrayType(bts_cursor_t *cursor, bts_extension_array_type_t * exts) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+    deserializeBtsVarint32Type(cursor, &exts->count);
 
-    gobbled = deserializeBtsVarint32Type(buffer, bufferLength, &exts->count);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    exts->dataLength = 0;  
-    if (exts->count > 0) {
-      exts->pFirst = buffer;
+    exts->dataLength = 0;
+    if (cursor->error == DESERIAL_OK && exts->count > 0) {
+      exts->pFirst = cursor->ptr;
     } else {
       exts->pFirst = NULL;
     }
 
-    PRINTF("DESERIAL: EXTS: %u Extensions detected; Read %d bytes; %d bytes remain\n",
-           exts->count, read, bufferLength);
+    PRINTF("DESERIAL: EXTS: %u Extensions detected; Status %d; %d bytes remain\n",
+           exts->count, cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
@@ -31,6 +31,6 @@ typedef struct bts_extension_array_t {
                                       // zero. Caller may set otherwise if
                                       // desired.)
 
-uint32_t deserializeBtsExtensionArrayType(const uint8_t *buffer, uint32_t bufferLength, bts_extension_array_type_t * exts);
+btsDeserialStatus_e deserializeBtsExtensionArrayType(bts_cursor_t *cursor, bts_extension_array_type_t * exts);
 
 #endif
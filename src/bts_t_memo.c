@@ -19,46 +19,65 @@
 #include "bts_t_memo.h"
 #include "os.h"
 
-uint32_t deserializeBtsMemoType(const uint8_t *buffer, uint32_t bufferLength, bts_memo_type_t * memo) {
+btsDeserialStatus_e deserializeBtsMemoType(bts_cursor_t *cursor, bts_memo_type_t * memo) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+    deserializeBtsPublicKeyType(cursor, &memo->fromPubkey);
+    deserializeBtsPublicKeyType(cursor, &memo->toPubkey);
+    cursorReadBytes(cursor, &memo->nonce, sizeof(uint64_t));
+    deserializeBtsVarint32Type(cursor, &memo->cipherTextLength);
 
-    gobbled = deserializeBtsPublicKeyType(buffer, bufferLength, &memo->fromPubkey);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+    memo->cipherText = cursor->ptr;
+    if (cursor->error == DESERIAL_OK) {
+        cursorReadBytes(cursor, NULL, memo->cipherTextLength);
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
 
-    gobbled = deserializeBtsPublicKeyType(buffer, bufferLength, &memo->toPubkey);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    PRINTF("DESERIAL: MEMO: %u cipher text bytes; Status %d; %d bytes remain\n",
+           memo->cipherTextLength, cursor->error, cursor->remaining);
 
-    gobbled = sizeof(uint64_t);
-    os_memmove(&memo->nonce, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    return cursor->error;
 
-    gobbled = deserializeBtsVarint32Type(buffer, bufferLength, &memo->cipherTextLength);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+}
 
-    memo->cipherText = buffer;
-    gobbled = memo->cipherTextLength;
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+void appendBtsMemoText(char *buffer, size_t bufferLength, size_t *written,
+                       const uint8_t *text, uint32_t length) {
+    static const char ellipsis[] = "...";
+    const size_t usable = bufferLength - sizeof(ellipsis);  // Room for "..." and NUL
+    for (uint32_t i = 0; i < length && *written < usable; i++) {
+        const uint8_t c = text[i];
+        buffer[(*written)++] = (c >= 0x20 && c < 0x7f) ? c : '?';
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    PRINTF("DESERIAL: MEMO: %u cipher text bytes; Read %d bytes; %d bytes remain\n",
-           memo->cipherTextLength, read, bufferLength);
+    if (*written == usable && length > 0) {
+        os_memmove(buffer + usable, ellipsis, sizeof(ellipsis));
+        *written = bufferLength - 1;
+    }
+    buffer[*written] = 0;
+}
 
-    return read;
+static bool isNullPublicKey(const bts_public_key_type_t *key) {
+    const uint8_t *bytes = (const uint8_t *)key;
+    for (uint32_t i = 0; i < sizeof(bts_public_key_type_t); i++) {
+        if (bytes[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
 
+void prettyPrintBtsMemoType(const bts_memo_type_t *memo, char *buffer, size_t bufferLength) {
+    size_t written = 0;
+    buffer[0] = 0;
+    if (isNullPublicKey(&memo->fromPubkey) && isNullPublicKey(&memo->toPubkey)) {
+        // Unencrypted: checksum, then the text as is.
+        if (memo->cipherTextLength >= BTS_MEMO_CHECKSUM_LENGTH) {
+            appendBtsMemoText(buffer, bufferLength, &written,
+                              memo->cipherText + BTS_MEMO_CHECKSUM_LENGTH,
+                              memo->cipherTextLength - BTS_MEMO_CHECKSUM_LENGTH);
+        }
+    } else if (!decryptBtsMemo(memo, buffer, bufferLength)) {
+        snprintf(buffer, bufferLength, "Encrypted, %u bytes", (unsigned int)memo->cipherTextLength);
+        return;
+    }
+    if (buffer[0] == 0) {
+        snprintf(buffer, bufferLength, "(Empty)");
+    }
 }
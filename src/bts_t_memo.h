@@ -32,6 +32,37 @@ typedef struct bts_memo_type_t {
     const uint8_t *       cipherText; // message start in OpData buffer
 } bts_memo_type_t;
 
-uint32_t deserializeBtsMemoType(const uint8_t *buffer, uint32_t bufferLength, bts_memo_type_t * memo);
+btsDeserialStatus_e deserializeBtsMemoType(bts_cursor_t *cursor, bts_memo_type_t * memo);
+
+/**
+ * Memo plaintext begins with a checksum: the first four bytes of the SHA-256 of
+ * the text that follows it.
+ */
+#define BTS_MEMO_CHECKSUM_LENGTH 4
+
+/**
+ * Pretty-prints the memo for review.  An unencrypted memo (one with null keys)
+ * is shown as is.  An encrypted one is decrypted with decryptBtsMemo() if the
+ * memo key is available, and otherwise only its length is shown.  The text is
+ * truncated with "..." to fit the buffer.
+ */
+void prettyPrintBtsMemoType(const bts_memo_type_t *memo, char *buffer, size_t bufferLength);
+
+/**
+ * Appends `length` bytes of memo text to the NUL-terminated `buffer`, whose
+ * current length is `*written`.  Non-printable bytes become '?'.  When the
+ * buffer fills, the text ends in "..." and the rest is dropped.
+ */
+void appendBtsMemoText(char *buffer, size_t bufferLength, size_t *written,
+                       const uint8_t *text, uint32_t length);
+
+/**
+ * Decrypts an encrypted memo with the memo key the host named for this
+ * transaction, into `buffer` via appendBtsMemoText().  Returns false if there is
+ * no memo key, the key is neither party to the memo, or the memo fails to
+ * decrypt or verify.  Provided by the app (app_memo.c); the host build, which
+ * holds no keys, provides one that always returns false.
+ */
+bool decryptBtsMemo(const bts_memo_type_t *memo, char *buffer, size_t bufferLength);
 
 #endif
@@ -19,25 +19,17 @@
 #include "bts_t_nullset.h"
 #include "os.h"
 
-uint32_t deserializeBtsNullSetType(const uint8_t *buffer, uint32_t bufferLength, bts_null_set_type_t * asset) {
+btsDeserialStatus_e deserializeBtsNullSetType(bts_cursor_t *cursor, bts_null_set_type_t * asset) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
-    uint8_t temp;
+    deserializeBtsVarint32Type(cursor, asset);
 
-    gobbled = deserializeBtsVarint32Type(buffer, bufferLength, asset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+    if (cursor->error == DESERIAL_OK && *asset != 0) {
+        cursorFail(cursor, DESERIAL_UNSUPPORTED);
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
 
-    if (*asset != 0) {
-        THROW(EXCEPTION);
-    }
-
-    PRINTF("DESERIAL: NULL_SET: %d; Read %d bytes; %d bytes remain\n",
-           (int)(*asset), read, bufferLength);
+    PRINTF("DESERIAL: NULL_SET: %d; Status %d; %d bytes remain\n",
+           (int)(*asset), cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
@@ -26,12 +26,12 @@
  * This is a placeholder type for unsupported list types. Used primarily for
  * extension lists that we are not yet supporting.  The type is essentially an alias
  * for varint32, which is used for set sizes. Only difference in implementation here
- * is we throw an exception if we deserialize a set size other than zero.  (Becuase,
+ * is we fail with DESERIAL_UNSUPPORTED if we deserialize a set size other than zero.  (Becuase,
  * presumably, we don't know how to deserialize whatever set elements might follow if
  * the size is non-zero.)
  */
 typedef bts_varint32_type_t bts_null_set_type_t;
 
-uint32_t deserializeBtsNullSetType(const uint8_t *buffer, uint32_t bufferLength, bts_null_set_type_t * asset);
+btsDeserialStatus_e deserializeBtsNullSetType(bts_cursor_t *cursor, bts_null_set_type_t * asset);
 
 #endif
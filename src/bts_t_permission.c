@@ -22,112 +22,66 @@
 #include "os.h"
 #include <string.h>
 
-uint32_t deserializeBtsPermissionType(const uint8_t *buffer, uint32_t bufferLength, bts_permission_type_t * perm) {
+btsDeserialStatus_e deserializeBtsPermissionType(bts_cursor_t *cursor, bts_permission_type_t * perm) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+    cursorReadBytes(cursor, &perm->weightThreshold, sizeof(uint32_t));
+    deserializeBtsVarint32Type(cursor, &perm->numAccountAuths);
 
-    gobbled = sizeof(uint32_t);
-    os_memmove(&perm->weightThreshold, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    perm->firstAccountAuth = cursor->ptr;
 
-    gobbled = deserializeBtsVarint32Type(buffer, bufferLength, &perm->numAccountAuths);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+    if (cursor->error == DESERIAL_OK) {     // Seek past account auth array
+        bts_account_auth_type_t dummy;
+        seekDeserializeBtsAccountAuthType(cursor, &dummy, perm->numAccountAuths);
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
 
-    perm->firstAccountAuth = buffer;
+    deserializeBtsVarint32Type(cursor, &perm->numKeyAuths);
 
-    bts_account_auth_type_t dummy;
-    gobbled = seekDeserializeBtsAccountAuthType(buffer, bufferLength, &dummy, perm->numAccountAuths);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    perm->firstKeyAuth = cursor->ptr;
 
-    gobbled = deserializeBtsVarint32Type(buffer, bufferLength, &perm->numKeyAuths);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+    if (cursor->error == DESERIAL_OK) {     // Seek past key auth array
+        if (perm->numKeyAuths > cursor->remaining / SIZEOF_BTS_KEY_AUTH_TYPE) {
+            cursorFail(cursor, DESERIAL_UNDERFLOW);
+        }
+        cursorReadBytes(cursor, NULL, perm->numKeyAuths * SIZEOF_BTS_KEY_AUTH_TYPE);
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
 
-    perm->firstKeyAuth = buffer;
+    deserializeBtsVarint32Type(cursor, &perm->numAddressAuths);
 
-    gobbled = perm->numKeyAuths * SIZEOF_BTS_KEY_AUTH_TYPE; // Seek past key auth array
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    if (cursor->error == DESERIAL_OK && perm->numAddressAuths != 0) {
+        cursorFail(cursor, DESERIAL_UNSUPPORTED);   // Need to get size right for permission
+    }                                               // record, so fail if this count not zero,
+                                                    // since I don't know proper way to decode
+                                                    // array if present.
 
-    gobbled = deserializeBtsVarint32Type(buffer, bufferLength, &perm->numAddressAuths);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    if (perm->numAddressAuths != 0) {   // Need to get size right for permission record,
-        THROW(EXCEPTION);               // so throw if this count not zero, since I don't
-    }                                   // know proper way to decode array if present.
-    
-    PRINTF("DESERIAL: PERMISSION: Thresh %u nAcc %u; 1st@ %p; nKey %u; 1st@ %p; Read %d bytes; %d bytes remain\n",
-           perm->weightThreshold, perm->numAccountAuths, perm->firstAccountAuth, perm->numKeyAuths, perm->firstKeyAuth, read, bufferLength);
+    PRINTF("DESERIAL: PERMISSION: Thresh %u nAcc %u; 1st@ %p; nKey %u; 1st@ %p; Status %d; %d bytes remain\n",
+           perm->weightThreshold, perm->numAccountAuths, perm->firstAccountAuth, perm->numKeyAuths, perm->firstKeyAuth, cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
 
-uint32_t seekDeserializeBtsAccountAuthType(const uint8_t *buffer, uint32_t bufferLength, bts_account_auth_type_t * auth, uint32_t seek) {
-
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+btsDeserialStatus_e seekDeserializeBtsAccountAuthType(bts_cursor_t *cursor, bts_account_auth_type_t * auth, uint32_t seek) {
 
-    for ( ; seek > 0; seek--) {
-        gobbled = deserializeBtsAccountIdType(buffer, bufferLength, &auth->accountId);
-        if (gobbled > bufferLength) {
-            THROW(EXCEPTION);
-        }
-        read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-        gobbled = sizeof(uint16_t);
-        os_memmove(&auth->weight, buffer, gobbled);
-        if (gobbled > bufferLength) {
-            THROW(EXCEPTION);
-        }
-        read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    for ( ; seek > 0 && cursor->error == DESERIAL_OK; seek--) {
+        deserializeBtsAccountIdType(cursor, &auth->accountId);
+        cursorReadBytes(cursor, &auth->weight, sizeof(uint16_t));
     }
 
-    PRINTF("DESERIAL: ACCT_AUTH: [1.3.%d]w%d; Read %d bytes; %d bytes remain\n",
-           (int)auth->accountId, (int)auth->weight, read, bufferLength);
+    PRINTF("DESERIAL: ACCT_AUTH: [1.3.%d]w%d; Status %d; %d bytes remain\n",
+           (int)auth->accountId, (int)auth->weight, cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
 
-uint32_t deserializeBtsKeyAuthType(const uint8_t *buffer, uint32_t bufferLength, bts_key_auth_type_t * auth) {
-
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+btsDeserialStatus_e deserializeBtsKeyAuthType(bts_cursor_t *cursor, bts_key_auth_type_t * auth) {
 
-    gobbled = deserializeBtsPublicKeyType(buffer, bufferLength, &auth->pubkey);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
-
-    gobbled = sizeof(uint16_t);
-    os_memmove(&auth->weight, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    deserializeBtsPublicKeyType(cursor, &auth->pubkey);
+    cursorReadBytes(cursor, &auth->weight, sizeof(uint16_t));
 
-    PRINTF("DESERIAL: KEY_AUTH: Read %d bytes; %d bytes remain\n", read, bufferLength);
+    PRINTF("DESERIAL: KEY_AUTH: Status %d; %d bytes remain\n", cursor->error, cursor->remaining);
 
-    return read;
+    return cursor->error;
 
 }
 
@@ -158,7 +112,9 @@ uint32_t prettyPrintBtsAccountAuthsList(bts_permission_type_t perm, char * buffe
     } else {
         for (uint32_t i = 0; i < perm.numAccountAuths; i++) {
             bts_account_auth_type_t tmpAccountAuth;
-            seekDeserializeBtsAccountAuthType(perm.firstAccountAuth,-1,&tmpAccountAuth,i+1);
+            bts_cursor_t cursor;
+            initBtsCursor(&cursor, perm.firstAccountAuth, -1);
+            seekDeserializeBtsAccountAuthType(&cursor, &tmpAccountAuth, i+1);
             prettyPrintBtsAccountAuth(tmpAccountAuth, buffer+written, bufferLength-written);
             written = strlen(buffer);
             if (i+1 != perm.numAccountAuths) {
@@ -201,7 +157,9 @@ uint32_t prettyPrintBtsKeyAuthsList(bts_permission_type_t perm, char * buffer, u
     } else {
         for (uint32_t i = 0; i < perm.numKeyAuths; i++) {
             bts_key_auth_type_t tmpAuth;
-            deserializeBtsKeyAuthType(perm.firstKeyAuth + i * SIZEOF_BTS_KEY_AUTH_TYPE, -1, &tmpAuth);
+            bts_cursor_t cursor;
+            initBtsCursor(&cursor, perm.firstKeyAuth + i * SIZEOF_BTS_KEY_AUTH_TYPE, -1);
+            deserializeBtsKeyAuthType(&cursor, &tmpAuth);
             prettyPrintBtsKeyAuth(tmpAuth, buffer+written, bufferLength-written);
             written = strlen(buffer);
             if (i+1 != perm.numKeyAuths) {
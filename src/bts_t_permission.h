@@ -66,17 +66,17 @@ struct bts_key_auth_type_t {
 };
 #define SIZEOF_BTS_KEY_AUTH_TYPE 35 // Serialized size of
 
-uint32_t deserializeBtsPermissionType(const uint8_t *buffer, uint32_t bufferLength, bts_permission_type_t * asset);
+btsDeserialStatus_e deserializeBtsPermissionType(bts_cursor_t *cursor, bts_permission_type_t * asset);
 
 /**
  * Seek Deserialize is different than deserialize in two ways: (1) We deserialize
- * `seek` records and return the `seek`th one in the ovalue, and (2) the retval is the
- * total number of bytes deserialized, not just those of the record returned.  The
+ * `seek` records and return the `seek`th one in the ovalue, and (2) the cursor is
+ * advanced past all `seek` records, not just the one returned.  The
  * function(s) work this way because they access arrays of variable-length records, so
  * the only way to find a specific one is to scan through them sequentially.
  */
-uint32_t seekDeserializeBtsAccountAuthType(const uint8_t *buffer, uint32_t bufferLength, bts_account_auth_type_t * auth, uint32_t seek);
-uint32_t deserializeBtsKeyAuthType(const uint8_t *buffer, uint32_t bufferLength, bts_key_auth_type_t * auth);
+btsDeserialStatus_e seekDeserializeBtsAccountAuthType(bts_cursor_t *cursor, bts_account_auth_type_t * auth, uint32_t seek);
+btsDeserialStatus_e deserializeBtsKeyAuthType(bts_cursor_t *cursor, bts_key_auth_type_t * auth);
 
 /**
  * Pretty-prints a list of Account Auths into a buffer. Will truncate at bufferLength.
@@ -22,21 +22,13 @@
 #include "os.h"
 #include <string.h>
 
-uint32_t deserializeBtsPublicKeyType(const uint8_t *buffer, uint32_t bufferLength, bts_public_key_type_t * keydata) {
+btsDeserialStatus_e deserializeBtsPublicKeyType(bts_cursor_t *cursor, bts_public_key_type_t * keydata) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+    cursorReadBytes(cursor, keydata, sizeof(bts_public_key_type_t));
 
-    gobbled = sizeof(bts_public_key_type_t);
-    os_memmove(keydata, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    PRINTF("DESERIAL: PUBKEY: Status %d; %d bytes remain\n", cursor->error, cursor->remaining);
 
-    PRINTF("DESERIAL: PUBKEY: Read %d bytes; %d bytes remain\n", read, bufferLength);
-
-    return read;
+    return cursor->error;
 
 }
 
@@ -19,6 +19,7 @@
 #ifndef __BTS_T_PUBKEY_H__
 #define __BTS_T_PUBKEY_H__
 
+#include "bts_types.h"
 #include "os.h"
 
 /**
@@ -35,7 +36,7 @@ typedef struct bts_public_key_type_t {
   uint8_t x[32];
 } bts_public_key_type_t;
 
-uint32_t deserializeBtsPublicKeyType(const uint8_t *buffer, uint32_t bufferLength, bts_public_key_type_t * keydata);
+btsDeserialStatus_e deserializeBtsPublicKeyType(bts_cursor_t *cursor, bts_public_key_type_t * keydata);
 
 /**
  * Pretty-prints the key in base58check including BTS prefix.
@@ -25,22 +25,14 @@
 
 static void bloodyHackyDateDecode(struct tm * tm, time_t ctime); /* defined at end */
 
-uint32_t deserializeBtsTimeType(const uint8_t *buffer, uint32_t bufferLength, bts_time_type_t * btsTime) {
+btsDeserialStatus_e deserializeBtsTimeType(bts_cursor_t *cursor, bts_time_type_t * btsTime) {
 
-    uint32_t read = 0;
-    uint32_t gobbled = 0;
+    cursorReadBytes(cursor, btsTime, sizeof(uint32_t));
 
-    gobbled = sizeof(uint32_t);
-    os_memmove(btsTime, buffer, gobbled);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
-    }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
+    PRINTF("DESERIAL: TIME: %.*H; Status %d; %d bytes remain\n",
+           sizeof(bts_time_type_t), btsTime, cursor->error, cursor->remaining);
 
-    PRINTF("DESERIAL: TIME: %.*H; Read %d bytes; %d bytes remain\n",
-           sizeof(bts_time_type_t), btsTime, read, bufferLength);
-
-    return read;
+    return cursor->error;
 
 }
 
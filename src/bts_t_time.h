@@ -19,19 +19,19 @@
 #ifndef __BTS_T_TIME_H__
 #define __BTS_T_TIME_H__
 
+#include "bts_types.h"
 #include "os.h"
 
 typedef uint32_t bts_time_type_t;
 
 /**
- * Deserializes a Time element from a bytestream. Reads from `buffer`, not to exceed
- * `bufferLength`, and puts result into `time`. Returns number of bytes read from
- * `buffer`.  The bts time format is a 32-bit seconds-since-1970.  Fortunately, this
+ * Deserializes a Time element from a bytestream. Reads from `cursor` and puts result
+ * into `time`. Returns deserialization status.  The bts time format is a 32-bit seconds-since-1970.  Fortunately, this
  * matches the time_t structure in BOLOS, so we can use library functions to get ascii
  * representation.  Unfortunately, leaves us with a year 2038 problem.  Not sure how
  * BitShares addresses this... but got a few years to find out...
  */
-uint32_t deserializeBtsTimeType(const uint8_t *buffer, uint32_t bufferLength, bts_time_type_t * time);
+btsDeserialStatus_e deserializeBtsTimeType(bts_cursor_t *cursor, bts_time_type_t * time);
 
 /**
  * Print an ascii representation of the `time` element into buffer.  We get away with
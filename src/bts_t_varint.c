@@ -22,18 +22,22 @@
 #include "os.h"
 #include <string.h>
 
-uint32_t deserializeBtsVarint48Type(const uint8_t *buffer, uint32_t bufferLength, bts_varint48_type_t * asset) {
+btsDeserialStatus_e deserializeBtsVarint48Type(bts_cursor_t *cursor, bts_varint48_type_t * asset) {
 
-    uint32_t read = 0;
     uint32_t gobbled = 0;
 
-    gobbled = unpack_varint48(buffer, asset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+    if (cursor->error != DESERIAL_OK) {
+        return cursor->error;
+    }
+    gobbled = unpack_varint48(cursor->ptr, cursor->remaining, asset);
+    if (gobbled == 0) {
+        return cursorFail(cursor, DESERIAL_OVERFLOW);
+    }
+    if (gobbled > cursor->remaining) {
+        return cursorFail(cursor, DESERIAL_UNDERFLOW);
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
 
-    return read;
+    return cursorReadBytes(cursor, NULL, gobbled);
 
 }
 
@@ -48,18 +52,22 @@ uint32_t prettyPrintBtsVarint48Type(const bts_varint48_type_t asset, char * buff
 
 }
 
-uint32_t deserializeBtsVarint32Type(const uint8_t *buffer, uint32_t bufferLength, bts_varint32_type_t * asset) {
+btsDeserialStatus_e deserializeBtsVarint32Type(bts_cursor_t *cursor, bts_varint32_type_t * asset) {
 
-    uint32_t read = 0;
     uint32_t gobbled = 0;
 
-    gobbled = unpack_varint32(buffer, asset);
-    if (gobbled > bufferLength) {
-        THROW(EXCEPTION);
+    if (cursor->error != DESERIAL_OK) {
+        return cursor->error;
+    }
+    gobbled = unpack_varint32(cursor->ptr, cursor->remaining, asset);
+    if (gobbled == 0) {
+        return cursorFail(cursor, DESERIAL_OVERFLOW);
+    }
+    if (gobbled > cursor->remaining) {
+        return cursorFail(cursor, DESERIAL_UNDERFLOW);
     }
-    read += gobbled; buffer += gobbled; bufferLength -= gobbled;
 
-    return read;
+    return cursorReadBytes(cursor, NULL, gobbled);
 
 }
 
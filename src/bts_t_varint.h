@@ -19,12 +19,13 @@
 #ifndef __BTS_T_VARINT_H__
 #define __BTS_T_VARINT_H__
 
+#include "bts_types.h"
 #include "os.h"
 
 typedef uint64_t bts_varint48_type_t;
 typedef uint32_t bts_varint32_type_t;
 
-uint32_t deserializeBtsVarint48Type(const uint8_t *buffer, uint32_t bufferLength, bts_varint48_type_t * asset);
-uint32_t deserializeBtsVarint32Type(const uint8_t *buffer, uint32_t bufferLength, bts_varint32_type_t * asset);
+btsDeserialStatus_e deserializeBtsVarint48Type(bts_cursor_t *cursor, bts_varint48_type_t * asset);
+btsDeserialStatus_e deserializeBtsVarint32Type(bts_cursor_t *cursor, bts_varint32_type_t * asset);
 
 #endif
@@ -0,0 +1,135 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "bts_totals.h"
+#include "app_ui_displays.h"
+#include "os.h"
+#include <stdint.h>
+
+#define printfContentLabel(...) snprintf(ui_buffers.sign_tx.paramLabel, sizeof(ui_buffers.sign_tx.paramLabel), __VA_ARGS__)
+#define printfContentParam(...) snprintf(ui_buffers.sign_tx.paramValue, sizeof(ui_buffers.sign_tx.paramValue), __VA_ARGS__)
+
+#ifdef HAVE_OP_ANY
+static bool addToTotal(const bts_asset_type_t *asset) {
+    uint8_t i;
+    for (i = 0; i < txContent.totalsCount; i++) {
+        if (txContent.totals[i].instanceId == asset->instanceId) {
+            break;
+        }
+    }
+    if (i == txContent.totalsCount) {
+        if (txContent.totalsCount >= TX_MAX_TOTALS) {
+            return false;
+        }
+        txContent.totals[i].instanceId = asset->instanceId;
+        txContent.totals[i].amount = 0;
+        txContent.totalsCount++;
+    }
+    if (asset->amount > (uint64_t)INT64_MAX - txContent.totals[i].amount) {
+        PRINTF("addToTotal: Overflow in total for asset %u\n", (uint32_t)asset->instanceId);
+        return false;
+    }
+    txContent.totals[i].amount += asset->amount;
+    return true;
+}
+#endif
+
+#if defined(HAVE_OP_CALL_ORDER_UPDATE) || defined(HAVE_OP_BID_COLLATERAL)
+/**
+ * For signed amounts, such as collateral and debt changes: adds `asset` if it's
+ * spent, i.e. if positive, or its magnitude if `negate` and it's negative.  The
+ * other sign is received, not spent.
+ */
+static bool addSignedToTotal(const bts_asset_type_t *asset, bool negate) {
+    bts_asset_type_t spent = *asset;
+    if (negate) {
+        spent.amount = (uint64_t)0 - spent.amount;
+    }
+    if ((int64_t)spent.amount <= 0) {
+        return true;
+    }
+    return addToTotal(&spent);
+}
+#endif
+
+bool addOperationToTotals(operationId_t opId, const bts_operation_u *op) {
+    switch (opId) {
+#ifdef HAVE_OP_TRANSFER
+    case OP_TRANSFER:
+        return addToTotal(&op->transfer.feeAsset)
+            && addToTotal(&op->transfer.transferAsset);
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CREATE
+    case OP_LIMIT_ORDER_CREATE:
+        return addToTotal(&op->limitOrderCreate.feeAsset)
+            && addToTotal(&op->limitOrderCreate.sellAsset);
+#endif
+#ifdef HAVE_OP_LIMIT_ORDER_CANCEL
+    case OP_LIMIT_ORDER_CANCEL:
+        return addToTotal(&op->limitOrderCancel.feeAsset);
+#endif
+#ifdef HAVE_OP_CALL_ORDER_UPDATE
+    case OP_CALL_ORDER_UPDATE:   // Collateral added, and debt repaid, are spent
+        return addToTotal(&op->callOrderUpdate.feeAsset)
+            && addSignedToTotal(&op->callOrderUpdate.deltaCollateral, false)
+            && addSignedToTotal(&op->callOrderUpdate.deltaDebt, true);
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPDATE
+    case OP_ACCOUNT_UPDATE:
+        return addToTotal(&op->accountUpdate.feeAsset);
+#endif
+#ifdef HAVE_OP_ACCOUNT_UPGRADE
+    case OP_ACCOUNT_UPGRADE:
+        return addToTotal(&op->accountUpgrade.feeAsset);
+#endif
+#ifdef HAVE_OP_PROPOSAL_CREATE
+    case OP_PROPOSAL_CREATE:
+        return addToTotal(&op->proposalCreate.feeAsset); // Proposed ops spend on approval
+#endif
+#ifdef HAVE_OP_BID_COLLATERAL
+    case OP_BID_COLLATERAL:
+        return addToTotal(&op->bidCollateral.feeAsset)
+            && addSignedToTotal(&op->bidCollateral.additionalCollateral, false);
+#endif
+    default:
+        txContent.uncountedOps++;
+        return true;
+    }
+}
+
+void printTxTotals() {
+
+    const uint8_t screens = txContent.totalsCount + (txContent.uncountedOps > 0 ? 1 : 0);
+    uint8_t index;
+
+    if (txContent.subargRemainP1 == 0) {
+        txContent.subargRemainP1 = (screens > 1) ? screens : 0;
+        index = 0;
+    } else {
+        index = screens - txContent.subargRemainP1;
+    }
+
+    if (index < txContent.totalsCount) {
+        printfContentLabel("Total %u of %u", index + 1, txContent.totalsCount);
+        prettyPrintBtsAssetType(txContent.totals[index], ui_buffers.sign_tx.paramValue);
+    } else {
+        printfContentLabel("Not in Totals");
+        printfContentParam("%u Unsupported Op%s", txContent.uncountedOps,
+                           txContent.uncountedOps > 1 ? "s" : "");
+    }
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+*  Copyright of the Contributing Authors, including:
+*
+*   (c) 2019 Christopher J. Sanborn
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __BTS_TOTALS_H__
+#define __BTS_TOTALS_H__
+
+#include "bts_stream.h"
+#include "bts_op_registry.h"
+
+/**
+ * Per-asset totals of what a transaction spends: fees, amounts transferred, and
+ * amounts offered for sale, summed across all of its displayable operations.
+ * Accumulated at ingest, as each cached operation is validated, into
+ * txContent.totals, and shown as the first review screens so the user sees what
+ * leaves the account before stepping through each operation.
+ */
+
+/**
+ * Adds what operation `op` (of type `opId`, already deserialized) spends to
+ * txContent.totals.  Returns false if a total would exceed the largest amount
+ * the chain can represent (share_type is a signed 64-bit integer), in which case
+ * the transaction cannot be valid.
+ */
+bool addOperationToTotals(operationId_t opId, const bts_operation_u *op);
+
+/**
+ * Prints the total for one asset into the sign_tx display buffers.  The first
+ * asset shows on the review step itself and the rest as sub-screens (see
+ * txContent.subargRemainP1), followed by a count of the operations that could
+ * not be totalled, if any.
+ */
+void printTxTotals();
+
+#endif
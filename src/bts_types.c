@@ -30,46 +30,85 @@
 #include <stdbool.h>
 #include "string.h"
 
-uint32_t unpack_varint32(const uint8_t *in, uint32_t *value) {
-    uint32_t i = 0;
-    uint64_t v = 0; char b = 0; uint8_t by = 0;
-    do {
-        b = *in; ++in; ++i;
-        v |= (uint64_t)((uint8_t)b & 0x7f) << by;
-        by += 7;
-    } while( ((uint8_t)b) & 0x80 && by < 35 );
+void initBtsCursor(bts_cursor_t *cursor, const uint8_t *buffer, uint32_t length) {
+    cursor->ptr = buffer;
+    cursor->remaining = length;
+    cursor->error = DESERIAL_OK;
+}
 
-    if( ((uint8_t)b) & 0x80 ) {         // Didn't hit terminating byte
-      THROW(EXCEPTION_OVERFLOW);
+btsDeserialStatus_e cursorReadBytes(bts_cursor_t *cursor, void *out, uint32_t length) {
+    if (cursor->error != DESERIAL_OK) {
+        return cursor->error;
+    }
+    if (length > cursor->remaining) {
+        return cursorFail(cursor, DESERIAL_UNDERFLOW);
     }
-    if ( v>>32 != 0 ) {                 // Too big
-      THROW(EXCEPTION_OVERFLOW);
+    if (out != NULL) {
+        os_memmove(out, cursor->ptr, length);
     }
+    cursor->ptr += length;
+    cursor->remaining -= length;
+    return DESERIAL_OK;
+}
 
-    *value = v;
-    return i;
+btsDeserialStatus_e cursorFail(bts_cursor_t *cursor, btsDeserialStatus_e status) {
+    if (cursor->error == DESERIAL_OK) {
+        cursor->error = status;
+    }
+    return cursor->error;
 }
 
-uint32_t unpack_varint48(const uint8_t *in, uint64_t *value) {
+/**
+ * Common bounded decoder for unpack_varint32/48.  The one- and two-byte cases are
+ * unrolled since they cover nearly every object instance id and size field we see
+ * (values below 16384), and they skip the loop and the width check entirely.
+ */
+static uint32_t unpack_varint_bounded(const uint8_t *in, uint32_t inLength,
+                                      uint32_t maxBytes, uint32_t valueBits, uint64_t *value) {
+    if (inLength >= 1 && (in[0] & 0x80) == 0) {
+        *value = in[0];
+        return 1;
+    }
+    if (inLength >= 2 && (in[1] & 0x80) == 0) {
+        *value = (uint64_t)(in[0] & 0x7f) | ((uint64_t)in[1] << 7);
+        return 2;
+    }
+
     uint32_t i = 0;
-    uint64_t v = 0; char b = 0; uint8_t by = 0;
+    uint64_t v = 0; uint8_t b = 0; uint8_t by = 0;
     do {
-        b = *in; ++in; ++i;
-        v |= (uint64_t)((uint8_t)b & 0x7f) << by;
+        if (i == inLength) {            // Ran off end of input
+          return inLength + 1;
+        }
+        b = in[i++];
+        v |= (uint64_t)(b & 0x7f) << by;
         by += 7;
-    } while( ((uint8_t)b) & 0x80 && by < 49 );
+    } while( (b & 0x80) && i < maxBytes );
 
-    if( ((uint8_t)b) & 0x80 ) {         // Didn't hit terminating byte
-      THROW(EXCEPTION_OVERFLOW);
+    if( b & 0x80 ) {                    // Didn't hit terminating byte
+      return 0;
     }
-    if ( v>>48 != 0 ) {                 // Too big
-      THROW(EXCEPTION_OVERFLOW);
+    if ( v>>valueBits != 0 ) {          // Too big
+      return 0;
     }
 
     *value = v;
     return i;
 }
 
+uint32_t unpack_varint32(const uint8_t *in, uint32_t inLength, uint32_t *value) {
+    uint64_t v = 0;
+    uint32_t read = unpack_varint_bounded(in, inLength, 5, 32, &v);
+    if (read != 0 && read <= inLength) {
+        *value = (uint32_t)v;
+    }
+    return read;
+}
+
+uint32_t unpack_varint48(const uint8_t *in, uint32_t inLength, uint64_t *value) {
+    return unpack_varint_bounded(in, inLength, 7, 48, value);
+}
+
 uint32_t public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength) {
     if (publicKey == NULL || keyLength < 33) {
         THROW(INVALID_PARAMETER);
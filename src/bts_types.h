@@ -32,19 +32,60 @@
 typedef uint8_t checksum256[32];
 typedef uint8_t public_key_t[33];
 
+/**
+ * Status codes returned by the deserializeBtsXXX() family of functions.  We report
+ * failure by return value rather than by THROW, so that exceptions are confined to
+ * the APDU dispatch in main.c and the stream parser needs no TRY context.
+ */
+typedef enum btsDeserialStatus_e {
+    DESERIAL_OK = 0,
+    DESERIAL_UNDERFLOW,     // Read would run past end of input
+    DESERIAL_OVERFLOW,      // Decoded value too large for destination type
+    DESERIAL_UNSUPPORTED,   // Well-formed, but not something we know how to decode
+} btsDeserialStatus_e;
+
+/**
+ * Read cursor over a serialized byte buffer.  Deserializers consume bytes by
+ * advancing `ptr` and decrementing `remaining`.  The first failure is latched in
+ * `error`, after which all further reads are no-ops returning that same status.
+ * Thus a deserializer can make a straight run of reads and check status once at
+ * the end.  (But it must check before branching on a value it has read.)
+ */
+typedef struct bts_cursor_t {
+    const uint8_t *     ptr;        // Next unread byte
+    uint32_t            remaining;  // Unread bytes from ptr to end of buffer
+    btsDeserialStatus_e error;      // Sticky; DESERIAL_OK until something fails
+} bts_cursor_t;
+
+void initBtsCursor(bts_cursor_t *cursor, const uint8_t *buffer, uint32_t length);
+
+/**
+ * Copies `length` bytes from the cursor into `out` and advances.  Bounds are
+ * checked before anything is copied.  If `out` is NULL, bytes are skipped.
+ */
+btsDeserialStatus_e cursorReadBytes(bts_cursor_t *cursor, void *out, uint32_t length);
+
+/**
+ * Latches `status` into the cursor unless an earlier error is already latched.
+ * Returns the latched status.
+ */
+btsDeserialStatus_e cursorFail(bts_cursor_t *cursor, btsDeserialStatus_e status);
+
 /**
  * Unpacks a variable-length encoded unsigned integer from a byte buffer into a
- * uint32.  Decoded value is written at `value`.  Returns number of bytes read from
- * input buffer.  Throws EXCEPTION_OVERFLOW if decoding exceeds 32 bits.
+ * uint32.  Reads no more than `inLength` bytes from `in`.  Decoded value is written
+ * at `value`.  Returns number of bytes read from input buffer, or zero if decoding
+ * exceeds 32 bits.  If input ends before the terminating byte, returns a count
+ * greater than `inLength` and `value` is not written.
  */
-uint32_t unpack_varint32(const uint8_t *in, uint32_t *value);
+uint32_t unpack_varint32(const uint8_t *in, uint32_t inLength, uint32_t *value);
 
 /**
  * Unpacks a variable-length unsigned integer up to 48-bits into a uint64. Similar
  * to 32-bit version, but this one can be used for BitShares instance_id's which can
- * be up to 48 bits. Throws EXCEPTION_OVERFLOW if decoding exceeds 48 bits.
+ * be up to 48 bits. Returns zero if decoding exceeds 48 bits.
  */
-uint32_t unpack_varint48(const uint8_t *in, uint64_t *value);
+uint32_t unpack_varint48(const uint8_t *in, uint32_t inLength, uint64_t *value);
 
 uint32_t public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength);
 uint32_t compressed_public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength);
@@ -30,12 +30,15 @@ bool b58enc(uint8_t *bin, uint32_t binsz, char *b58, uint32_t *b58sz)
 	int carry;
 	uint32_t i, j, high, zcount = 0;
 	uint32_t size;
+	uint8_t buf[B58ENC_MAX_INPUT * 138 / 100 + 1];
+	
+	if (binsz > B58ENC_MAX_INPUT)
+		return false;
 	
 	while (zcount < binsz && !bin[zcount])
 		++zcount;
 	
 	size = (binsz - zcount) * 138 / 100 + 1;
-	uint8_t buf[size];
 	os_memset(buf, 0, size);
 	
 	for (i = zcount, high = size - 1; i < binsz; ++i, high = j)
@@ -77,7 +80,7 @@ void array_hexstr(char *strbuf, const void *bin, unsigned int len) {
     while (len--) {
         *strbuf++ = hex_digits[((*((char *)bin)) >> 4) & 0xF];
         *strbuf++ = hex_digits[(*((char *)bin)) & 0xF];
-        bin = (const void *)((unsigned int)bin + 1);
+        bin = (const uint8_t *)bin + 1;
     }
     *strbuf = 0; // EOS
 }
@@ -21,6 +21,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// Largest input b58enc() accepts: a compressed public key plus checksum.
+// Bounds its work buffer, so that its stack frame is fixed.
+#define B58ENC_MAX_INPUT 37
+
 bool b58enc(uint8_t *data, uint32_t binsz, char *b58, uint32_t *b58sz);
 
 void array_hexstr(char *strbuf, const void *bin, unsigned int len);
@@ -30,6 +30,7 @@
 #include "cx.h"
 #include "os_io_seproxyhal.h"
 
+#include "app_memo.h"
 #include "app_nvm.h"
 #include "app_ux.h"
 #include "app_ui_menus.h"
@@ -46,10 +47,13 @@ unsigned int io_seproxyhal_touch_exit(const bagl_element_t *e);
 #define INS_GET_PUBLIC_KEY 0x02
 #define INS_SIGN 0x04
 #define INS_GET_APP_CONFIGURATION 0x06
+#define INS_ENCRYPT_MEMO 0x08
 #define P1_CONFIRM 0x01
 #define P1_NON_CONFIRM 0x00
 #define P2_NO_CHAINCODE 0x00
 #define P2_CHAINCODE 0x01
+#define P2_NO_MEMO_KEY 0x00
+#define P2_MEMO_KEY 0x01            // INS_SIGN: memo key path follows signing path
 #define P1_FIRST 0x00
 #define P1_MORE 0x80
 
@@ -69,6 +73,7 @@ uint8_t instruction = 0x00;             // APDU INS byte.  Some ux steps need to
 unsigned int io_seproxyhal_touch_exit(const bagl_element_t *e)
 {
     // Go back to the dashboard
+    memoSecretCacheWipe();
     os_sched_exit(0);
     return 0; // do not redraw the widget
 }
@@ -184,6 +189,16 @@ void handleGetAppConfiguration(uint8_t p1, uint8_t p2, const uint8_t *workBuffer
     THROW(0x9000);
 }
 
+/**
+ * True if `path` is a SLIP-0048 memo key (48'/network'/3'/...).  Only those are
+ * used for memo ECDH: doing it with an owner or active key would put that key to
+ * a use it was never meant for.
+ */
+static bool isMemoKeyPath(const uint32_t *path, uint8_t pathLength)
+{
+    return (pathLength >= 3) && (path[0] == 0x80000030) && (path[2] == 0x80000003);
+}
+
 void handleSign(uint8_t p1, uint8_t p2, const uint8_t *workBuffer,
                 uint16_t dataLength, volatile unsigned int *flags,
                 volatile unsigned int *tx)
@@ -209,6 +224,33 @@ void handleSign(uint8_t p1, uint8_t p2, const uint8_t *workBuffer,
             workBuffer += 4;
             dataLength -= 4;
         }
+        tmpCtx.transactionContext.memoPathLength = 0;
+        if (p2 == P2_MEMO_KEY)
+        {
+            const uint8_t memoPathLength = workBuffer[0];
+            if ((memoPathLength < 0x01) || (memoPathLength > MAX_BIP32_PATH) ||
+                (dataLength < 1 + 4 * memoPathLength))
+            {
+                PRINTF("Invalid memo key path\n");
+                THROW(0x6a80);
+            }
+            workBuffer++;
+            dataLength--;
+            for (i = 0; i < memoPathLength; i++)
+            {
+                tmpCtx.transactionContext.memoPath[i] =
+                    (workBuffer[0] << 24) | (workBuffer[1] << 16) |
+                    (workBuffer[2] << 8) | (workBuffer[3]);
+                workBuffer += 4;
+                dataLength -= 4;
+            }
+            if (!isMemoKeyPath(tmpCtx.transactionContext.memoPath, memoPathLength))
+            {
+                PRINTF("Not a memo key path\n");
+                THROW(0x6a80);
+            }
+            tmpCtx.transactionContext.memoPathLength = memoPathLength;
+        }
         initTxProcessingContext(&sha256, &txIdSha256);
         initTxProcessingContent();
     }
@@ -216,7 +258,7 @@ void handleSign(uint8_t p1, uint8_t p2, const uint8_t *workBuffer,
     {
         THROW(0x6B00);
     }
-    if (p2 != 0)
+    if ((p2 != P2_NO_MEMO_KEY) && (p2 != P2_MEMO_KEY))
     {
         THROW(0x6B00);
     }
@@ -253,13 +295,80 @@ void handleSign(uint8_t p1, uint8_t p2, const uint8_t *workBuffer,
     cx_hash(&txIdSha256.header, CX_LAST, txContent.txIdHash, 0, txContent.txIdHash);
 
     // Prepare and initiate UX_DISPLAY sequence:
-    ux_step = 0;
-    ux_step_count = 3 + txContent.argumentCount;
+    ux_step = UX_STEP_SIGN_CONFIRM;
+    ux_step_count = UX_STEP_SIGN_ARGUMENTS + txContent.argumentCount;
     ui_display_signTxConfirmation_nanos();
 
     *flags |= IO_ASYNCH_REPLY;
 }
 
+void handleEncryptMemo(uint8_t p1, uint8_t p2, const uint8_t *workBuffer,
+                       uint16_t dataLength, volatile unsigned int *flags,
+                       volatile unsigned int *tx)
+{
+    uint32_t i;
+    uint8_t *text;
+    if (p2 != 0x00)
+    {
+        THROW(0x6B00);
+    }
+    if (p1 == P1_FIRST)
+    {
+        uint32_t path[MAX_BIP32_PATH];
+        const uint8_t pathLength = workBuffer[0];
+        bts_public_key_type_t recipient;
+        uint64_t nonce = 0;
+        uint32_t textLength = 0;
+
+        memoEncryptAbort();
+        if ((pathLength < 0x01) || (pathLength > MAX_BIP32_PATH) ||
+            (dataLength < 1 + 4 * pathLength + sizeof(recipient) + 8 +
+                              BTS_MEMO_CHECKSUM_LENGTH + 4))
+        {
+            PRINTF("Invalid memo header\n");
+            THROW(0x6a80);
+        }
+        workBuffer++;
+        dataLength--;
+        for (i = 0; i < pathLength; i++)
+        {
+            path[i] = (workBuffer[0] << 24) | (workBuffer[1] << 16) |
+                      (workBuffer[2] << 8) | (workBuffer[3]);
+            workBuffer += 4;
+            dataLength -= 4;
+        }
+        if (!isMemoKeyPath(path, pathLength))
+        {
+            PRINTF("Not a memo key path\n");
+            THROW(0x6a80);
+        }
+        os_memmove(&recipient, workBuffer, sizeof(recipient));
+        workBuffer += sizeof(recipient);
+        for (i = 0; i < 8; i++)
+        {
+            nonce = (nonce << 8) | workBuffer[i];
+        }
+        for (i = 0; i < 4; i++)
+        {
+            textLength = (textLength << 8) | workBuffer[8 + BTS_MEMO_CHECKSUM_LENGTH + i];
+        }
+        memoEncryptBegin(path, pathLength, &recipient, nonce, workBuffer + 8, textLength);
+        workBuffer += 8 + BTS_MEMO_CHECKSUM_LENGTH + 4;
+        dataLength -= sizeof(recipient) + 8 + BTS_MEMO_CHECKSUM_LENGTH + 4;
+    }
+    else if (p1 != P1_MORE)
+    {
+        THROW(0x6B00);
+    }
+
+    // The ciphertext goes out from the start of the APDU buffer, and can get
+    // ahead of the text it comes from; so move the text to the end first.
+    text = G_io_apdu_buffer + sizeof(G_io_apdu_buffer) - dataLength;
+    os_memmove(text, workBuffer, dataLength);
+    *tx = memoEncryptUpdate(text, dataLength, G_io_apdu_buffer);
+    THROW(0x9000);
+}
+
 void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
 {
     unsigned short sw = 0;
@@ -273,6 +382,11 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                 THROW(0x6E00);
             }
 
+            if (G_io_apdu_buffer[OFFSET_INS] != INS_ENCRYPT_MEMO)
+            {
+                memoEncryptAbort();     // Other instructions overwrite tmpCtx
+            }
+
             switch (G_io_apdu_buffer[OFFSET_INS])
             {
             case INS_GET_PUBLIC_KEY:
@@ -299,6 +413,14 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                     G_io_apdu_buffer[OFFSET_LC], flags, tx);
                 break;
 
+            case INS_ENCRYPT_MEMO:
+                instruction = INS_ENCRYPT_MEMO;
+                handleEncryptMemo(G_io_apdu_buffer[OFFSET_P1],
+                                  G_io_apdu_buffer[OFFSET_P2],
+                                  G_io_apdu_buffer + OFFSET_CDATA,
+                                  G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
             default:
                 instruction = 0x00;
                 THROW(0x6D00);
@@ -315,6 +437,7 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
             {
             case 0x6000:
                 // Wipe the transaction context and report the exception
+                memoEncryptAbort();
                 sw = e;
                 break;
             case 0x9000:
@@ -323,6 +446,7 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                 break;
             default:
                 // Internal error
+                memoEncryptAbort();
                 sw = 0x6800 | (e & 0x7FF);
                 break;
             }
@@ -458,7 +582,8 @@ unsigned char io_event(unsigned char channel)
                     PRINTF("TICKER.in:  Step: %u, Count %u; Ins: %d; CurrentOp: %u, OpCount: %u\n",
                            ux_step, ux_step_count, (int)instruction, txContent.currentOperation, txContent.operationCount);
                     ux_step = (ux_step + 1);// % ux_step_count;
-                    if (ux_step > 2 && instruction == INS_SIGN) {   // Special Case:
+                    if ((ux_step == UX_STEP_SIGN_TOTALS + 1 || ux_step >= UX_STEP_SIGN_ARGUMENTS)
+                        && instruction == INS_SIGN) {               // Special Case:
                         if (txContent.subargRemainP1 > 1) {         //  Do not advance ux_step if subarguments
                             ux_step--;                              //  remain to be displayed. See
                         }                                           //  txProcessingContent_t for explanation
@@ -469,16 +594,16 @@ unsigned char io_event(unsigned char channel)
                     if (ux_step >= ux_step_count) {
                         txContent.currentOperation = (txContent.currentOperation + 1) % txContent.operationCount;
                         if (txContent.currentOperation != 0 && instruction == INS_SIGN) {
-                            ux_step = 2;    // If we are signing a Tx with multiple Ops,
-                        } else {            // only go back to step zero when we cycle back
-                            ux_step = 0;    // to the first op in the list.
-                        }
+                            ux_step = UX_STEP_SIGN_OPERATION;   // If we are signing a Tx with
+                        } else {                                // multiple Ops, only go back to
+                            ux_step = UX_STEP_SIGN_CONFIRM;     // step zero when we cycle back
+                        }                                       // to the first op in the list.
                     }
-                    if (ux_step == 2 && instruction == INS_SIGN) {
+                    if (ux_step == UX_STEP_SIGN_OPERATION && instruction == INS_SIGN) {
                         updateOperationContent();   // sets argcount, parser, and
                                                     // prints operation name into
                                                     // display buffer
-                        ux_step_count = 3 + txContent.argumentCount;
+                        ux_step_count = UX_STEP_SIGN_ARGUMENTS + txContent.argumentCount;
                     }
                     PRINTF("TICKER.out: Step: %u, Count %u; Ins: %d; CurrentOp: %u, OpCount: %u\n",
                            ux_step, ux_step_count, (int)instruction, txContent.currentOperation, txContent.operationCount);
@@ -502,6 +627,7 @@ unsigned char io_event(unsigned char channel)
 
 void app_exit(void)
 {
+    memoSecretCacheWipe();
     BEGIN_TRY_L(exit)
     {
         TRY_L(exit)
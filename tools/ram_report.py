@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""
+/*******************************************************************************
+*  Copyright of the Contributing Authors; see CONTRIBUTORS.md.
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+##
+## RAM budget report for the app ELF: static RAM per symbol (.bss and .data),
+## and worst-case stack depth over the call graph.  Exits nonzero if either is
+## over budget, so `make ramreport` can fail the build.
+##
+## Stack frames come from the compiler's -fstack-usage output (.su files) when
+## the app is built with STACK_USAGE=1, and otherwise from each function's
+## prologue (push / vpush / sub sp) in the disassembly.  Call edges come from
+## the disassembly: direct calls, and tail calls (branches to the start of
+## another function).  Indirect calls can't be resolved this way; name their
+## possible targets with --indirect-target (e.g. the op registry's parsers), and
+## every function making an indirect call is assumed to call them all.  Other
+## indirect calls, and recursion, are listed for review rather than counted.
+##
+## Needs only objdump and nm for the target; pass --objdump/--nm, or set
+## OBJDUMP/NM, to use other than arm-none-eabi-*.
+##
+
+import argparse
+import glob
+import os
+import re
+import subprocess
+import sys
+
+FUNC_RE = re.compile(r'^([0-9a-f]+) <([^>]+)>:$')
+CALL_RE = re.compile(r'\s(?:bl|blx|call|callq)\s+[0-9a-f]+ <([^>+@]+)(?:@plt)?>')
+TAIL_RE = re.compile(r'\s(?:b|b\.w|b\.n|jmp|jmpq)\s+[0-9a-f]+ <([^>+@]+)(?:@plt)?>')
+INDIRECT_RE = re.compile(r'\s(?:blx\s+r\d+|blx\s+(?:ip|lr)|call[q]?\s+\*)')
+PUSH_RE = re.compile(r'\s(?:push|stmdb\s+sp!,)(?:\.w)?\s+\{([^}]*)\}')
+VPUSH_RE = re.compile(r'\svpush\s+\{([^}]*)\}')
+SUBSP_RE = re.compile(r'\ssub(?:\.w|w)?\s+sp,\s*(?:sp,\s*)?#(\d+)')
+SUBSP_REG_RE = re.compile(r'\ssub(?:\.w)?\s+sp,\s*(?:sp,\s*)?r\d+')
+STATIC_TYPES = {'b': '.bss', 'B': '.bss', 'd': '.data', 'D': '.data'}
+
+
+def run(command):
+    return subprocess.run(command, check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout
+
+
+def registerCount(reglist, width):
+    count = 0
+    for part in reglist.split(','):
+        part = part.strip()
+        bounds = re.match(r'([a-z]+)(\d+)-[a-z]+(\d+)$', part)
+        count += int(bounds.group(3)) - int(bounds.group(2)) + 1 if bounds else 1
+    return count * width
+
+
+def readStackUsage(directory):
+    """func -> (bytes, dynamic) from every .su file under `directory`."""
+    frames = {}
+    for path in glob.glob(os.path.join(directory, '**', '*.su'), recursive=True):
+        with open(path) as f:
+            for line in f:
+                fields = line.rstrip('\n').split('\t')
+                if len(fields) < 3:
+                    continue
+                func = fields[0].rsplit(':', 1)[-1]
+                size, dynamic = int(fields[1]), 'dynamic' in fields[2] and 'bounded' not in fields[2]
+                old = frames.get(func, (0, False))
+                frames[func] = (max(size, old[0]), dynamic or old[1])
+    return frames
+
+
+def readDisassembly(objdump, elf):
+    """
+    Returns (frames, calls, indirect): prologue frame sizes, call edges, and the
+    set of functions making indirect calls.
+    """
+    frames, calls, indirect = {}, {}, set()
+    func, prologue = None, 0
+    for line in run([objdump, '-d', '--no-show-raw-insn', elf]).splitlines():
+        header = FUNC_RE.match(line)
+        if header:
+            func, prologue = header.group(2), 0
+            frames[func] = (0, False)
+            calls[func] = set()
+            continue
+        if func is None or not line.strip():
+            continue
+        prologue += 1
+        call = CALL_RE.search(line) or TAIL_RE.search(line)
+        if call and call.group(1) != func:
+            calls[func].add(call.group(1))
+        if INDIRECT_RE.search(line):
+            indirect.add(func)
+        if prologue <= 6:
+            size, dynamic = frames[func]
+            push, vpush, sub = PUSH_RE.search(line), VPUSH_RE.search(line), SUBSP_RE.search(line)
+            if push:
+                size += registerCount(push.group(1), 4)
+            elif vpush:
+                size += registerCount(vpush.group(1), 8)
+            elif sub:
+                size += int(sub.group(1))
+            elif SUBSP_REG_RE.search(line):
+                dynamic = True
+            frames[func] = (size, dynamic)
+    # Only tail calls to the start of a known function are calls; other
+    # branches with a symbol are jumps within the caller.
+    for func in calls:
+        calls[func] = {c for c in calls[func] if c in calls}
+    return frames, calls, indirect
+
+
+def worstCase(root, frames, calls):
+    """(depth, path) of the deepest call chain from `root`, plus recursive functions seen."""
+    memo, recursive = {}, set()
+
+    def visit(func, onPath):
+        if func in memo:
+            return memo[func]
+        onPath.add(func)
+        best = (0, [])
+        for callee in calls.get(func, ()):
+            if callee in onPath:
+                recursive.add(callee)
+                continue
+            depth, path = visit(callee, onPath)
+            if depth > best[0]:
+                best = (depth, path)
+        onPath.discard(func)
+        memo[func] = (frames.get(func, (0, False))[0] + best[0], [func] + best[1])
+        return memo[func]
+
+    depth, path = visit(root, set())
+    return depth, path, recursive
+
+
+def staticSymbols(nm, elf):
+    """List of (size, section, name) for every .bss/.data symbol, largest first."""
+    symbols = []
+    for line in run([nm, '-S', '--size-sort', '-t', 'd', elf]).splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in STATIC_TYPES:
+            symbols.append((int(fields[1]), STATIC_TYPES[fields[2]], fields[3]))
+    symbols.sort(reverse=True)
+    return symbols
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Report static RAM and worst-case stack use of an app ELF.")
+    parser.add_argument('elf', help="linked app, e.g. bin/app.elf")
+    parser.add_argument('--su-dir', help="directory holding -fstack-usage .su files, e.g. obj")
+    parser.add_argument('--root', action='append', help="entry point(s) to measure stack depth from (default: main)")
+    parser.add_argument('--stack-budget', type=int, help="fail if worst-case stack depth exceeds this many bytes")
+    parser.add_argument('--ram-budget', type=int, help="fail if .bss plus .data exceeds this many bytes")
+    parser.add_argument('--indirect-target', action='append', default=[],
+                        help="regex of functions reachable through function pointers")
+    parser.add_argument('--top', type=int, default=15, help="number of largest symbols and frames to list")
+    parser.add_argument('--objdump', default=os.environ.get('OBJDUMP', 'arm-none-eabi-objdump'))
+    parser.add_argument('--nm', default=os.environ.get('NM', 'arm-none-eabi-nm'))
+    args = parser.parse_args()
+
+    frames, calls, indirect = readDisassembly(args.objdump, args.elf)
+    targets = {f for f in calls for pattern in args.indirect_target if re.search(pattern, f)}
+    for func in indirect:
+        calls[func] |= targets - {func}
+    source = "prologues"
+    if args.su_dir:
+        measured = readStackUsage(args.su_dir)
+        if measured:
+            for func in frames:
+                # GCC lists clone foo.constprop.0 as foo.constprop.
+                size = (measured.get(func) or measured.get(re.sub(r'\.\d+$', '', func))
+                        or measured.get(func.split('.')[0]))
+                if size is not None:
+                    frames[func] = size
+            source = ".su files"
+    symbols = staticSymbols(args.nm, args.elf)
+    failed = False
+
+    print("Static RAM (largest %d symbols):" % args.top)
+    for size, section, name in symbols[:args.top]:
+        print("  %6d  %-5s  %s" % (size, section, name))
+    totals = {s: sum(size for size, section, _ in symbols if section == s) for s in ('.bss', '.data')}
+    ram = totals['.bss'] + totals['.data']
+    print("  %6d  total (.bss %d, .data %d)" % (ram, totals['.bss'], totals['.data']))
+    if args.ram_budget is not None:
+        print("  budget %d: %s" % (args.ram_budget, "OK" if ram <= args.ram_budget else "EXCEEDED"))
+        failed = failed or ram > args.ram_budget
+
+    print("\nLargest stack frames (from %s):" % source)
+    for func, (size, dynamic) in sorted(frames.items(), key=lambda kv: -kv[1][0])[:args.top]:
+        print("  %6d  %s%s" % (size, func, "  (dynamic)" if dynamic else ""))
+
+    for root in args.root or ['main']:
+        if root not in calls:
+            sys.exit("No function %s in %s" % (root, args.elf))
+        depth, path, recursive = worstCase(root, frames, calls)
+        print("\nWorst-case stack from %s: %d bytes" % (root, depth))
+        for func in path:
+            size, dynamic = frames.get(func, (0, False))
+            print("  %6d  %s%s" % (size, func, "  (dynamic)" if dynamic else ""))
+        reachable = set()
+        pending = [root]
+        while pending:
+            func = pending.pop()
+            if func not in reachable:
+                reachable.add(func)
+                pending.extend(calls.get(func, ()))
+        unbounded = sorted(f for f in reachable if frames.get(f, (0, False))[1])
+        if recursive:
+            print("  Recursive, counted once: %s" % ", ".join(sorted(recursive)))
+        if unbounded:
+            print("  Dynamic frames, not bounded: %s" % ", ".join(unbounded))
+        if reachable & indirect:
+            print("  Indirect calls%s in: %s" % (" (to --indirect-target functions)" if targets else ", not followed,",
+                                                ", ".join(sorted(reachable & indirect))))
+        if args.stack_budget is not None:
+            over = depth > args.stack_budget or bool(unbounded)
+            print("  budget %d: %s" % (args.stack_budget, "EXCEEDED" if over else "OK"))
+            failed = failed or over
+
+    sys.exit(1 if failed else 0)
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""
+/*******************************************************************************
+*  Copyright of the Contributing Authors; see CONTRIBUTORS.md.
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+##
+## Flash size report for the app ELF: code and read-only data per source file
+## and per function, optionally diffed against a saved baseline.
+##
+## Symbols are attributed to source files through their debug line info (nm
+## -l), which survives LTO, where the linker map only knows ltrans objects.
+## Symbols without line info (libc, libgcc, assembler) are grouped as "(other)".
+##
+##     tools/size_report.py bin/app.elf --save baseline.json     # before
+##     tools/size_report.py bin/app.elf --baseline baseline.json # after
+##
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+FLASH_TYPES = {'t': 'text', 'T': 'text', 'r': 'rodata', 'R': 'rodata'}
+
+
+def run(command):
+    return subprocess.run(command, check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout
+
+
+def flashSymbols(nm, elf):
+    """{name: {'size', 'kind', 'module'}} for every code and read-only data symbol."""
+    symbols = {}
+    for line in run([nm, '-S', '-l', '-t', 'd', elf]).splitlines():
+        fields = line.split('\t')
+        parts = fields[0].split()
+        if len(parts) != 4 or parts[2] not in FLASH_TYPES:
+            continue
+        size, name = int(parts[1]), parts[3]
+        module = os.path.basename(fields[1].rsplit(':', 1)[0]) if len(fields) > 1 else "(other)"
+        if name in symbols:
+            # Same-named statics in different files.
+            name = "%s (%s)" % (name, module)
+        symbols[name] = {'size': size, 'kind': FLASH_TYPES[parts[2]], 'module': module}
+    return symbols
+
+
+def summarize(symbols):
+    modules = {}
+    for sym in symbols.values():
+        totals = modules.setdefault(sym['module'], {'text': 0, 'rodata': 0})
+        totals[sym['kind']] += sym['size']
+    return {'modules': modules,
+            'functions': {n: s['size'] for n, s in symbols.items() if s['kind'] == 'text'},
+            'total': sum(s['size'] for s in symbols.values())}
+
+
+def delta(new, old):
+    return "%+d" % (new - old) if new != old else ""
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Report flash use of an app ELF per source file and per function.")
+    parser.add_argument('elf', help="linked app, e.g. bin/app.elf")
+    parser.add_argument('--baseline', help="JSON from an earlier --save, to diff against")
+    parser.add_argument('--save', help="write this build's sizes to JSON file SAVE, for use as a baseline")
+    parser.add_argument('--top', type=int, default=25, help="number of largest (or most changed) functions to list")
+    parser.add_argument('--flash-budget', type=int, help="fail if code plus read-only data exceeds this many bytes")
+    parser.add_argument('--nm', default=os.environ.get('NM', 'arm-none-eabi-nm'))
+    args = parser.parse_args()
+
+    summary = summarize(flashSymbols(args.nm, args.elf))
+    base = None
+    if args.baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            base = json.load(f)
+    elif args.baseline:
+        print("No baseline at %s; run with --save to create one.\n" % args.baseline)
+
+    modules = summary['modules']
+    oldModules = base['modules'] if base else {}
+    print("%-32s %8s %8s %8s %8s" % ("Source file", "text", "rodata", "total", "change"))
+    names = sorted(set(modules) | set(oldModules),
+                   key=lambda m: -sum(modules.get(m, oldModules.get(m, {})).values()))
+    for name in names:
+        sizes = modules.get(name, {'text': 0, 'rodata': 0})
+        old = sum(oldModules[name].values()) if name in oldModules else None
+        print("%-32s %8d %8d %8d %8s" % (name, sizes['text'], sizes['rodata'], sum(sizes.values()),
+                                         delta(sum(sizes.values()), old) if old is not None else
+                                         ("new" if base else "")))
+    print("%-32s %8s %8s %8d %8s" % ("Total", "", "", summary['total'],
+                                     delta(summary['total'], base['total']) if base else ""))
+
+    functions = summary['functions']
+    if base:
+        oldFunctions = base['functions']
+        changed = [(functions.get(n, 0) - oldFunctions.get(n, 0), n)
+                   for n in set(functions) | set(oldFunctions)
+                   if functions.get(n, 0) != oldFunctions.get(n, 0)]
+        changed.sort(key=lambda c: -abs(c[0]))
+        print("\nLargest function changes:")
+        for change, name in changed[:args.top]:
+            print("  %+7d  %7d  %s" % (change, functions.get(name, 0), name))
+        if not changed:
+            print("  (none)")
+    else:
+        print("\nLargest functions:")
+        for name, size in sorted(functions.items(), key=lambda kv: -kv[1])[:args.top]:
+            print("  %7d  %s" % (size, name))
+
+    if args.save:
+        with open(args.save, 'w') as f:
+            json.dump(summary, f, indent=1, sort_keys=True)
+        print("\nSaved sizes to %s" % args.save)
+
+    if args.flash_budget is not None:
+        print("\nFlash budget %d: %s" % (args.flash_budget,
+                                         "OK" if summary['total'] <= args.flash_budget else "EXCEEDED"))
+        if summary['total'] > args.flash_budget:
+            sys.exit(1)